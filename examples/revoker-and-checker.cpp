@@ -55,7 +55,7 @@ main(int argc, char* argv[])
     auto issuerRecord = revoker.revokeAsIssuer(ownerCert, tlv::ReasonCode::SUPERSEDED);
     Name appendPrefix = Name(ledgerPrefix).append("append");
     client.appendData(appendPrefix, {*ownerRecord, *issuerRecord},
-      [&] (auto&&, auto& ack) {
+      [&] (auto&&, auto& ack, auto&&) {
         Block content = ack.getContent();
         content.parse();
         for (auto elem : content.elements()) {
@@ -13,6 +13,8 @@ std::string statusToString(AppendStatus status)
       return "FAILURE_TIMEOUT";
     case AppendStatus::FAILURE_STORAGE:
       return "FAILURE_STORAGE";
+    case AppendStatus::FAILURE_QUOTA:
+      return "FAILURE_QUOTA";
     case AppendStatus::FAILURE_VALIDATION_APP:
       return "FAILURE_VALIDATION_APP";
     case AppendStatus::FAILURE_VALIDATION_PROTO:
@@ -12,7 +12,8 @@ namespace ndnrevoke::appendtlv {
 // AppendParameter =
 //     [Name]
 //     [ForwardingHint]
-// Temporarily we don't consider segementation
+// The submission is segmented: /<prefix>/msg/<topic>/<nonce>/<segment>, each segment
+// carrying whole Data, and the ack lists the status of every Data
 
 // AppendResponse =
 //     [Name]
@@ -50,6 +51,7 @@ enum class AppendStatus : uint64_t {
   FAILURE_VALIDATION_APP = 4,
   FAILURE_VALIDATION_PROTO = 5,
   FAILURE_STORAGE = 98,
+  FAILURE_QUOTA = 99,
 };
 
 std::string statusToString(AppendStatus status);
@@ -26,22 +26,37 @@ ClientOptions::makeInterestFilter()
                           .appendNumber(getNonce());
 }
 
-std::shared_ptr<Data>
-ClientOptions::makeSubmission(const std::list<Data>& dataList)
+std::vector<std::shared_ptr<Data>>
+ClientOptions::makeSubmission(const std::list<Data>& dataList, size_t maxSegmentSize)
 {
-  // Data: /<m_prefix>/msg/<topic>/<nonce>
-  Name name = Name(getPrefix()).append("msg").append(m_topic)
-                               .appendNumber(getNonce());
-  auto data = std::make_shared<Data>(name);
+  std::vector<Block> contents;
   Block content(ndn::tlv::Content);
-  int dataCount = 0;
+  size_t contentSize = 0;
   for (auto& item : dataList) {
-    dataCount++;
-    content.push_back(item.wireEncode());
+    const auto& wire = item.wireEncode();
+    if (contentSize > 0 && contentSize + wire.size() > maxSegmentSize) {
+      contents.push_back(std::move(content));
+      content = Block(ndn::tlv::Content);
+      contentSize = 0;
+    }
+    content.push_back(wire);
+    contentSize += wire.size();
+  }
+  contents.push_back(std::move(content));
+
+  // Data: /<m_prefix>/msg/<topic>/<nonce>/<segment>
+  std::vector<std::shared_ptr<Data>> segments;
+  auto finalBlock = ndn::name::Component::fromSegment(contents.size() - 1);
+  for (size_t i = 0; i < contents.size(); i++) {
+    Name name = makeInterestFilter();
+    auto data = std::make_shared<Data>(name.appendSegment(i));
+    contents[i].encode();
+    data->setContent(contents[i]);
+    data->setFreshnessPeriod(time::seconds(4));
+    data->setFinalBlock(finalBlock);
+    segments.push_back(std::move(data));
   }
-  content.encode();
-  data->setContent(content);
-  return data;
+  return segments;
 }
 
 std::list<AppendStatus>
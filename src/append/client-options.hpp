@@ -11,8 +11,12 @@ class ClientOptions : boost::noncopyable
 {
 public:
   const ssize_t MAX_RETRIES = 3;
+  // leaves room in a segment for its name and signature
+  static constexpr size_t MAX_SEGMENT_SIZE = 7000;
 
-  using onSuccessCallback = std::function<void(const std::list<Data>&, const Data&)>; // notification ack
+  // the validated notification ack, and the statuses of the Data of the callback in it
+  using onSuccessCallback = std::function<void(const std::list<Data>&, const Data&,
+                                               const std::list<AppendStatus>&)>;
   using onFailureCallback = std::function<void(const std::list<Data>&, const Error&)>; // notification ack
 
   explicit
@@ -72,19 +76,25 @@ public:
   std::shared_ptr<Interest>
   makeFetcher();
 
-  std::shared_ptr<Data>
-  makeSubmission(const std::list<Data>& dataList);
+  /**
+   * @brief Pack the Data into the unsigned segments of a submission.
+   *
+   * A segment holds whole Data only, up to @p maxSegmentSize bytes of them unless a single
+   * Data is larger, so that each segment can be validated and stored as soon as it arrives.
+   */
+  std::vector<std::shared_ptr<Data>>
+  makeSubmission(const std::list<Data>& dataList, size_t maxSegmentSize = MAX_SEGMENT_SIZE);
 
   std::shared_ptr<Data>
   makeNotificationAck(const std::list<AppendStatus>& statusList);
 
-  std::list<AppendStatus>
-  praseAck(const Data& data); 
+  static std::list<AppendStatus>
+  praseAck(const Data& data);
 
   void
-  onSuccess(const std::list<Data>& data, const Data& ack)
+  onSuccess(const std::list<Data>& data, const Data& ack, const std::list<AppendStatus>& statuses)
   {
-    return m_sCb(data, ack);
+    return m_sCb(data, ack, statuses);
   }
 
   void
@@ -30,6 +30,7 @@ Client::dispatchNotification(const std::shared_ptr<ClientOptions>& options, cons
 {
   auto interest = options->makeNotification();
   if (options->exhaustRetries()) {
+    m_submissions.erase(options->getNonce());
     options->onFailure(data, Error(Error::Code::TIMEOUT, interest->getName().toUri()));
     return;
   }
@@ -45,8 +46,9 @@ Client::dispatchNotification(const std::shared_ptr<ClientOptions>& options, cons
           onValidationFailure(options, data, error);
         });
     }, 
-    [options, data] (auto& i, auto& n) {
+    [this, options, data] (auto& i, auto& n) {
       NDN_LOG_ERROR("Notification Nack: " << n.getReason()); 
+      m_submissions.erase(options->getNonce());
       options->onFailure(data, Error(Error::Code::NACK, i.getName().toUri()));
     },
     [this, options, data] (const auto&) { dispatchNotification(options, data);}
@@ -65,25 +67,130 @@ Client::appendData(const Name& topic, const std::list<Data>& data,
     return appendtlv::InvalidNonce;
   }
 
-  auto options = std::make_shared<ClientOptions>(m_prefix, topic,
-      ndn::random::generateSecureWord64(), onSuccess, onFailure);
-  // prepare submission
-  Name filterName = options->makeInterestFilter();
-  auto filterId = m_face.setInterestFilter(filterName,
-    [this, options, data] (auto&&, const auto& i) {
-      auto submission = options->makeSubmission(data);
-      m_keyChain.sign(*submission, ndn::signingByIdentity(options->getPrefix()));
-      m_face.put(*submission);
-      NDN_LOG_TRACE("Submitting " << *submission);  
-    }
-  );
-  // handle the unregsiter task in destructor
-  m_handle.handleFilter(filterId);
-  NDN_LOG_TRACE("Registering filter for " << filterName);
+  if (m_maxBatchSize == 0) {
+    return submit(topic, data, ndn::random::generateSecureWord64(), onSuccess, onFailure);
+  }
+
+  auto it = m_batches.find(topic);
+  if (it != m_batches.end() && it->second.nData + data.size() > m_maxBatchSize) {
+    flushBatch(topic);
+    it = m_batches.end();
+  }
+  if (it == m_batches.end()) {
+    it = m_batches.emplace(topic, Batch{ndn::random::generateSecureWord64()}).first;
+    it->second.flushEvent = m_scheduler.schedule(m_batchWindow, [this, topic] { flushBatch(topic); });
+  }
+  auto& batch = it->second;
+  batch.appends.push_back({data, onSuccess, onFailure});
+  batch.nData += data.size();
+  uint64_t nonce = batch.nonce;
+  if (batch.nData >= m_maxBatchSize) {
+    flushBatch(topic);
+  }
+  return nonce;
+}
+
+void
+Client::enableCoalescing(time::milliseconds window, size_t maxBatchSize)
+{
+  m_batchWindow = window;
+  m_maxBatchSize = maxBatchSize;
+}
+
+void
+Client::flushBatch(const Name& topic)
+{
+  auto it = m_batches.find(topic);
+  if (it == m_batches.end()) {
+    return;
+  }
+  uint64_t nonce = it->second.nonce;
+  auto appends = std::make_shared<std::vector<PendingAppend>>(std::move(it->second.appends));
+  m_batches.erase(it);
+
+  std::list<Data> data;
+  for (const auto& append : *appends) {
+    data.insert(data.end(), append.data.begin(), append.data.end());
+  }
+  NDN_LOG_TRACE("Submitting " << data.size() << " coalesced Data to " << topic);
+  submit(topic, data, nonce,
+    [appends] (auto&&, const Data& ack, const std::list<AppendStatus>& statusList) {
+      std::vector<AppendStatus> statuses(statusList.begin(), statusList.end());
+      size_t index = 0;
+      for (const auto& append : *appends) {
+        // an ack cut short by a failure ends with the status of the failure
+        std::list<AppendStatus> callerStatuses;
+        for (size_t i = 0; i < append.data.size(); i++, index++) {
+          callerStatuses.push_back(index < statuses.size() ? statuses[index] :
+                                   statuses.empty() ? AppendStatus::FAILURE_STORAGE : statuses.back());
+        }
+        if (append.onSuccess) {
+          append.onSuccess(append.data, ack, callerStatuses);
+        }
+      }
+    },
+    [appends] (auto&&, const Error& error) {
+      for (const auto& append : *appends) {
+        if (append.onFailure) {
+          append.onFailure(append.data, error);
+        }
+      }
+    });
+}
+
+uint64_t
+Client::submit(const Name& topic, const std::list<Data>& data, uint64_t nonce,
+               const ClientOptions::onSuccessCallback onSuccess,
+               const ClientOptions::onFailureCallback onFailure)
+{
+  auto options = std::make_shared<ClientOptions>(m_prefix, topic, nonce, onSuccess, onFailure);
+  // prepare submission, signed once however many times a segment is asked for
+  auto segments = options->makeSubmission(data);
+  for (auto& segment : segments) {
+    m_keyChain.sign(*segment, ndn::signingByIdentity(options->getPrefix()));
+  }
+  m_submissions[nonce] = std::move(segments);
+  // one filter per topic serves the submissions of all nonces
+  Name topicFilter = options->makeInterestFilter().getPrefix(-1);
+  if (m_topicFilters.insert(topicFilter).second) {
+    auto filterId = m_face.setInterestFilter(topicFilter,
+      [this, topicFilter] (auto&&, const auto& i) { onSubmissionInterest(topicFilter, i); });
+    // handle the unregsiter task in destructor
+    m_handle.handleFilter(filterId);
+    NDN_LOG_TRACE("Registering filter for " << topicFilter);
+  }
   dispatchNotification(options, data);
   return options->getNonce();
 }
 
+void
+Client::onSubmissionInterest(const Name& topicFilter, const Interest& interest)
+{
+  // Interest: /<m_prefix>/msg/<topic>/<nonce>[/<segment>]
+  const Name& name = interest.getName();
+  if (name.size() <= topicFilter.size() || !name[topicFilter.size()].isNumber()) {
+    NDN_LOG_TRACE("No nonce in " << name);
+    return;
+  }
+  auto it = m_submissions.find(name[topicFilter.size()].toNumber());
+  if (it == m_submissions.end()) {
+    NDN_LOG_TRACE("No submission in flight for " << name);
+    return;
+  }
+  const auto& segments = it->second;
+  // the first Interest of the fetcher carries no segment number
+  uint64_t segmentNo = 0;
+  if (name.size() > topicFilter.size() + 1 && name[topicFilter.size() + 1].isSegment()) {
+    segmentNo = name[topicFilter.size() + 1].toSegment();
+  }
+  if (segmentNo >= segments.size()) {
+    NDN_LOG_TRACE("No segment for " << name);
+    return;
+  }
+  m_face.put(*segments[segmentNo]);
+  NDN_LOG_TRACE("Submitting " << segments[segmentNo]->getName());
+}
+
 void
 Client::onValidationSuccess(const std::shared_ptr<ClientOptions>& options, const std::list<Data>& data, const Data& ack)
 {
@@ -97,8 +204,8 @@ Client::onValidationSuccess(const std::shared_ptr<ClientOptions>& options, const
       NDN_LOG_TRACE("There are individual submissions failed by CT");
     }
   }
-  m_retryCount = 0;
-  options->onSuccess(data, ack);
+  m_submissions.erase(options->getNonce());
+  options->onSuccess(data, ack, statusList);
 }
 
 void
@@ -106,6 +213,7 @@ Client::onValidationFailure(const std::shared_ptr<ClientOptions>& options, const
                                  const ndn::security::ValidationError& error)
 {
   NDN_LOG_ERROR("Error authenticating ACK: " << error);
+  m_submissions.erase(options->getNonce());
   options->onFailure(data, Error(Error::Code::VALIDATION_ERROR, error.getInfo()));
 }
 
@@ -5,6 +5,11 @@
 #include "append/client-options.hpp"
 #include "error.hpp"
 
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <set>
+#include <unordered_map>
+
 namespace ndnrevoke::append {
 
 class Client : boost::noncopyable
@@ -20,12 +25,43 @@ public:
          const Name& fwHint,
          ndn::KeyChain& keyChain, ndn::security::Validator& validator);
 
+  /**
+   * @return the nonce of the submission carrying the Data, shared by the Data coalesced with them
+   */
   uint64_t
   appendData(const Name& topic, const std::list<Data>& data,
              const ClientOptions::onSuccessCallback onSuccess,
              const ClientOptions::onFailureCallback onFailure);
 
+  /**
+   * @brief Coalesce the Data appended to the same topic within @p window into one submission
+   *        of at most @p maxBatchSize Data.
+   *
+   * Each caller still gets its own callbacks with its own Data; onSuccess is handed the
+   * validated ack of the whole submission as signed by the CT, and the statuses of the
+   * caller's Data only.
+   */
+  void
+  enableCoalescing(time::milliseconds window, size_t maxBatchSize);
+
 NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  uint64_t
+  submit(const Name& topic, const std::list<Data>& data, uint64_t nonce,
+         const ClientOptions::onSuccessCallback onSuccess,
+         const ClientOptions::onFailureCallback onFailure);
+
+  /**
+   * @brief Submit the Data being coalesced for @p topic.
+   */
+  void
+  flushBatch(const Name& topic);
+
+  /**
+   * @brief Serve a segment of the in-flight submission whose nonce the Interest carries.
+   */
+  void
+  onSubmissionInterest(const Name& topicFilter, const Interest& interest);
+
   void
   dispatchNotification(const std::shared_ptr<ClientOptions>& options, const std::list<Data>& data);
 
@@ -36,13 +72,37 @@ NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   onValidationFailure(const std::shared_ptr<ClientOptions>& options, const std::list<Data>& data,
                       const ndn::security::ValidationError& error);
 
-  ssize_t m_retryCount = 0;
   ndn::Face& m_face;
   Name m_prefix;
   Handle m_handle;
 
   ndn::KeyChain& m_keyChain;
   ndn::security::Validator& m_validator;
+
+  struct PendingAppend
+  {
+    std::list<Data> data;
+    ClientOptions::onSuccessCallback onSuccess;
+    ClientOptions::onFailureCallback onFailure;
+  };
+
+  struct Batch
+  {
+    uint64_t nonce;
+    std::vector<PendingAppend> appends;
+    size_t nData = 0;
+    ndn::scheduler::ScopedEventId flushEvent;
+  };
+
+  // coalescing is off while m_maxBatchSize is 0
+  time::milliseconds m_batchWindow = 0_ms;
+  size_t m_maxBatchSize = 0;
+  ndn::Scheduler m_scheduler{m_face.getIoService()};
+  std::map<Name, Batch> m_batches;
+
+  // signed segments of the submissions in flight, by nonce, until acked or given up
+  std::unordered_map<uint64_t, std::vector<std::shared_ptr<Data>>> m_submissions;
+  std::set<Name> m_topicFilters;
 };
 
 } // namespace ndnrevoke:append
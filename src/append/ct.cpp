@@ -4,6 +4,8 @@
 namespace ndnrevoke::append {
 NDN_LOG_INIT(ndnrevoke.append);
 
+const size_t Ct::MAX_SUBMISSION_DATA = 2000;
+
 Ct::Ct(const Name& prefix, const Name& topic, ndn::Face& face, 
        ndn::KeyChain& keyChain, ndn::security::Validator& validator)
   : m_prefix(prefix)
@@ -11,65 +13,59 @@ Ct::Ct(const Name& prefix, const Name& topic, ndn::Face& face,
   , m_topic(topic)
   , m_keyChain(keyChain)
   , m_validator(validator)
+  , m_signingInfo(ndn::signingByIdentity(prefix))
 {
 }
 
 void
 Ct::serveClient(std::shared_ptr<ClientOptions> client)
 {
-  auto fetcher =  m_options.makeFetcher(*client);
-  if (client->exhaustRetries()) {
-    NDN_LOG_ERROR("Interest " << *fetcher << " run out of retries");
-    // acking notification
-    auto ack = m_options.makeNotificationAck(*client, {AppendStatus::FAILURE_TIMEOUT});
-    m_keyChain.sign(*ack, ndn::signingByIdentity(m_prefix));
-    m_face.put(*ack);
-    NDN_LOG_TRACE("Putting notification ack");
+  auto fetcher = m_options.makeFetcher(*client);
+  if (m_inFlight.count(fetcher->getName()) > 0) {
+    // a retransmitted notification, answered by the ack of the submission in flight
+    NDN_LOG_TRACE("Submission already in flight " << fetcher->getName());
     return;
   }
-  
-  NDN_LOG_TRACE("Sending out interest " << *fetcher);
-  m_face.expressInterest(*fetcher, 
-    [this, client] (auto& i, const auto& submission) {
-      NDN_LOG_TRACE("Receiving submission data " << submission.getName());
-      m_validator.validate(submission, 
-        [this, submission, client] (const Data&) {
-          NDN_LOG_DEBUG("D1 conforms to trust schema");
-          onValidationSuccess(submission, client);
-        },
-        [this, submission, client] (const Data&, const ndn::security::ValidationError& error) {
-          NDN_LOG_ERROR("Error authenticating D1: " << error);
-          onValidationFailure(submission, error, client);
-        });
-    },
-    [this, client] (const auto& i, auto& n) {
-      // acking notification
-      auto ack = m_options.makeNotificationAck(*client, {AppendStatus::FAILURE_NACK});
-      m_keyChain.sign(*ack, ndn::signingByIdentity(m_prefix));
-      m_face.put(*ack);
-      NDN_LOG_TRACE("Putting notification ack");
-    },
-    [this, client] (const auto& i) {
-      NDN_LOG_TRACE("Retry");
-      serveClient(client);
+  NDN_LOG_TRACE("Fetching submission " << *fetcher);
+  auto submission = std::make_shared<Submission>();
+  submission->client = client;
+  submission->name = fetcher->getName();
+  m_inFlight.emplace(submission->name, submission);
+  // the segments are fetched in a window, validated, and updated as they arrive
+  auto segmentFetcher = ndn::util::SegmentFetcher::start(m_face, *fetcher, m_validator, m_fetcherOptions);
+  submission->fetcher = segmentFetcher;
+  segmentFetcher->afterSegmentValidated.connect([this, submission] (const Data& segment) {
+    onSegment(segment, submission);
+  });
+  segmentFetcher->onComplete.connect([this, submission] (auto&&) {
+    // an aborted submission is already done
+    if (submission->isFetched) {
+      return;
+    }
+    submission->isFetched = true;
+    if (submission->nPending == 0) {
+      onSubmissionDone(submission);
     }
-  );
+  });
+  segmentFetcher->onError.connect([this, submission] (uint32_t errorCode, const std::string& errorMsg) {
+    onFetchError(errorCode, errorMsg, submission);
+  });
 }
 
 void
-Ct::listen(const UpdateCallback& onUpdateCallback)
+Ct::listen(const UpdateCallback& onUpdateCallback, const CommitCallback& onCommitCallback)
 {
   if (m_topic.empty()) {
     NDN_LOG_TRACE("No topic to listen, return\n");
     return;
   }
   m_onUpdate = onUpdateCallback;
+  m_onCommit = onCommitCallback;
 
   auto filterId = m_face.setInterestFilter(Name(m_topic).append("notify"),
     [this] (auto&&, const auto& i) { 
       NDN_LOG_TRACE("Receiving notification " << i);
       auto client = m_options.praseNotification(i);
-      auto fetcher = m_options.makeFetcher(*client);
       serveClient(client);
     });
   m_handle.handleFilter(filterId);
@@ -77,47 +73,151 @@ Ct::listen(const UpdateCallback& onUpdateCallback)
 }
 
 void
-Ct::onValidationSuccess(const Data& data, std::shared_ptr<ClientOptions> client)
+Ct::onSegment(const Data& segment, std::shared_ptr<Submission> submission)
 {
-  auto content = data.getContent();
+  NDN_LOG_TRACE("Receiving submission segment " << segment.getName());
+  if (submission->isFetched) {
+    return;
+  }
+  auto content = segment.getContent();
 
-  std::list<AppendStatus> statusList;
-  m_retryCount = 0;
-  content.parse();
-  ssize_t count = 0;
-  AppendStatus statusCode;
-  for (const auto &it : content.elements()) {
-    switch (it.type()) {
-      case ndn::tlv::Data:
-        count++;
-        statusCode = m_onUpdate(Data(it));
-        statusList.push_back(statusCode);
-        break;
-      default:
-        if (ndn::tlv::isCriticalType(it.type())) {
-          NDN_THROW(std::runtime_error("Unrecognized TLV Type: " + std::to_string(it.type())));
-        }
-        else {
-          //ignore
+  std::vector<Data> items;
+  try {
+    content.parse();
+    for (const auto &it : content.elements()) {
+      switch (it.type()) {
+        case ndn::tlv::Data:
+          items.emplace_back(it);
+          break;
+        default:
+          if (ndn::tlv::isCriticalType(it.type())) {
+            NDN_THROW(std::runtime_error("Unrecognized TLV Type: " + std::to_string(it.type())));
+          }
+          else {
+            //ignore
+          }
+          break;
+      }
+    }
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Malformed submission segment " << segment.getName() << ": " << e.what());
+    return abortSubmission(submission, AppendStatus::FAILURE_VALIDATION_PROTO);
+  }
+  if (submission->nData + items.size() > MAX_SUBMISSION_DATA) {
+    NDN_LOG_ERROR("Submission " << submission->name << " has more than " << MAX_SUBMISSION_DATA << " Data");
+    return abortSubmission(submission, AppendStatus::FAILURE_VALIDATION_PROTO);
+  }
+  uint64_t segmentNo = segment.getName()[-1].toSegment();
+  if (segmentNo < submission->nextSegment || !submission->buffered.emplace(segmentNo, std::move(items)).second) {
+    return;
+  }
+  submission->nData += submission->buffered[segmentNo].size();
+  dispatchSegments(submission);
+}
+
+void
+Ct::dispatchSegments(std::shared_ptr<Submission> submission)
+{
+  // segments may arrive out of order, but updates are applied in submission order
+  auto& buffered = submission->buffered;
+  while (!buffered.empty() && buffered.begin()->first == submission->nextSegment) {
+    uint64_t segmentNo = submission->nextSegment++;
+    auto items = std::move(buffered.begin()->second);
+    buffered.erase(buffered.begin());
+    submission->statuses[segmentNo].resize(items.size());
+    submission->nPending += items.size();
+    for (size_t i = 0; i < items.size(); i++) {
+      m_onUpdate(submission->name, items[i], [this, submission, segmentNo, i] (AppendStatus status) {
+        submission->statuses[segmentNo][i] = status;
+        if (--submission->nPending == 0 && submission->isFetched) {
+          onSubmissionDone(submission);
         }
-        break;
+      });
     }
   }
-  // acking notification
-  auto ack = m_options.makeNotificationAck(*client, statusList);
-  m_keyChain.sign(*ack, ndn::signingByIdentity(m_prefix));
-  m_face.put(*ack);
-  NDN_LOG_TRACE("Putting notification ack");
 }
 
 void
-Ct::onValidationFailure(const Data& data, const ndn::security::ValidationError& error,
-                              std::shared_ptr<ClientOptions> client)
+Ct::onFetchError(uint32_t errorCode, const std::string& errorMsg, std::shared_ptr<Submission> submission)
 {
-  // acking notification
-  NDN_LOG_TRACE("Putting notification ack");
-  auto ack = m_options.makeNotificationAck(*client, {AppendStatus::FAILURE_VALIDATION_PROTO});
-  m_keyChain.sign(*ack, ndn::signingByIdentity(m_prefix));
-  m_face.put(*ack);
+  NDN_LOG_ERROR("Error fetching submission: " << errorMsg);
+  if (submission->isFetched) {
+    return;
+  }
+  using ndn::util::SegmentFetcher;
+  switch (errorCode) {
+    case SegmentFetcher::INTEREST_TIMEOUT:
+      submission->failure = AppendStatus::FAILURE_TIMEOUT;
+      break;
+    case SegmentFetcher::NACK_ERROR:
+      submission->failure = AppendStatus::FAILURE_NACK;
+      break;
+    default:
+      submission->failure = AppendStatus::FAILURE_VALIDATION_PROTO;
+      break;
+  }
+  submission->isFetched = true;
+  if (submission->nPending == 0) {
+    onSubmissionDone(submission);
+  }
+}
+
+void
+Ct::abortSubmission(std::shared_ptr<Submission> submission, AppendStatus failure)
+{
+  if (auto fetcher = submission->fetcher.lock()) {
+    fetcher->stop();
+  }
+  submission->failure = failure;
+  submission->isFetched = true;
+  if (submission->nPending == 0) {
+    onSubmissionDone(submission);
+  }
+}
+
+void
+Ct::onSubmissionDone(std::shared_ptr<Submission> submission)
+{
+  m_doneSubmissions.push_back(std::move(submission));
+  if (m_doneSubmissions.size() == 1) {
+    m_commitEvent = m_scheduler.schedule(0_ms, [this] { commitSubmissions(); });
+  }
+}
+
+void
+Ct::commitSubmissions()
+{
+  auto submissions = std::move(m_doneSubmissions);
+  m_doneSubmissions.clear();
+  // one commit covers all the Data of the done submissions
+  bool isDurable = !m_onCommit || m_onCommit();
+  if (!isDurable) {
+    // the failed commit also rolled back the Data updated so far by the submissions still
+    // being fetched
+    for (auto& inFlight : m_inFlight) {
+      for (auto& segment : inFlight.second->statuses) {
+        std::replace(segment.second.begin(), segment.second.end(), AppendStatus::SUCCESS, AppendStatus::FAILURE_STORAGE);
+      }
+    }
+  }
+  for (const auto& submission : submissions) {
+    std::list<AppendStatus> statusList;
+    for (const auto& segment : submission->statuses) {
+      statusList.insert(statusList.end(), segment.second.begin(), segment.second.end());
+    }
+    if (!isDurable) {
+      std::replace(statusList.begin(), statusList.end(), AppendStatus::SUCCESS, AppendStatus::FAILURE_STORAGE);
+    }
+    if (submission->failure) {
+      statusList.push_back(*submission->failure);
+    }
+    // acking notification
+    auto ack = m_options.makeNotificationAck(*submission->client, statusList);
+    m_keyChain.sign(*ack, m_signingInfo);
+    m_inFlight.erase(submission->name);
+    m_face.put(*ack);
+    NDN_LOG_TRACE("Putting notification ack");
+  }
 }
 } // namespace ndnrevoke::append
@@ -4,10 +4,31 @@
 #include "append/ct-options.hpp"
 #include "append/handle.hpp"
 
+#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
+
 namespace ndnrevoke::append {
 using appendtlv::AppendStatus;
 
-using UpdateCallback = std::function<AppendStatus(const Data&)>;
+using UpdateDoneCallback = std::function<void(AppendStatus)>;
+/**
+ * @brief Called on each Data of a submission, which must call the UpdateDoneCallback exactly
+ *        once with the status of the Data, right away or later, e.g., after the Data is validated.
+ *
+ * The Data of a submission, and of different submissions, are updated concurrently; the Data
+ * of a segment are updated once the segment is fetched and validated, while later segments
+ * are still being fetched.  The Data of one submission are passed in their submitted order,
+ * with the name of the submission, /<client-prefix>/msg/<topic>/<nonce>.
+ */
+using UpdateCallback = std::function<void(const Name& submission, const Data&, const UpdateDoneCallback&)>;
+/**
+ * @brief Called once the submissions whose updates are all done in the same round of the
+ *        event loop are about to be acked, so that they share one commit.
+ * @return whether the updates are durable; if not, the SUCCESS statuses of every update
+ *         so far, including those of the submissions still being fetched, are turned
+ *         into FAILURE_STORAGE
+ */
+using CommitCallback = std::function<bool()>;
 
 class Ct : boost::noncopyable
 {
@@ -17,30 +38,100 @@ public:
      ndn::KeyChain& keyChain, ndn::security::Validator& validator);
 
   void
-  listen(const UpdateCallback& onUpdateCallback);
+  listen(const UpdateCallback& onUpdateCallback, const CommitCallback& onCommitCallback = nullptr);
+
+  /**
+   * @brief Set how the segments of submissions are fetched.
+   */
+  void
+  setFetcherOptions(const ndn::util::SegmentFetcher::Options& options)
+  {
+    m_fetcherOptions = options;
+  }
+
+  /**
+   * @brief Set how acks are signed, by the identity of the CT prefix by default.
+   */
+  void
+  setSigningInfo(const ndn::security::SigningInfo& signingInfo)
+  {
+    m_signingInfo = signingInfo;
+  }
+
+public:
+  // Data per submission, so that the statuses of a submission fit in one ack packet
+  static const size_t MAX_SUBMISSION_DATA;
 
 NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief A submission whose segments are being fetched and whose Data are being updated.
+   */
+  struct Submission
+  {
+    std::shared_ptr<ClientOptions> client;
+    Name name;
+    std::weak_ptr<ndn::util::SegmentFetcher> fetcher;
+    size_t nData = 0;
+    // segments received ahead of the next one to dispatch, by segment number
+    std::map<uint64_t, std::vector<Data>> buffered;
+    uint64_t nextSegment = 0;
+    // statuses of the Data of each segment, by segment number
+    std::map<uint64_t, std::vector<AppendStatus>> statuses;
+    size_t nPending = 0;
+    bool isFetched = false;
+    // why the fetching stopped early, acked after the statuses of the fetched Data
+    optional<AppendStatus> failure;
+  };
+
   void
   serveClient(std::shared_ptr<ClientOptions> client);
 
   void
-  onValidationSuccess(const Data& data, std::shared_ptr<ClientOptions> client);
+  onSegment(const Data& segment, std::shared_ptr<Submission> submission);
+
+  /**
+   * @brief Hand the Data of the buffered segments to the update callback, strictly in
+   *        segment order, up to the first segment still missing.
+   */
+  void
+  dispatchSegments(std::shared_ptr<Submission> submission);
+
+  void
+  onFetchError(uint32_t errorCode, const std::string& errorMsg, std::shared_ptr<Submission> submission);
+
+  /**
+   * @brief Stop fetching @p submission and ack it with @p failure after the Data updated so far.
+   */
+  void
+  abortSubmission(std::shared_ptr<Submission> submission, AppendStatus failure);
+
+  void
+  onSubmissionDone(std::shared_ptr<Submission> submission);
 
+  /**
+   * @brief Commit the done submissions at once and ack them.
+   */
   void
-  onValidationFailure(const Data& data, const ndn::security::ValidationError& error,
-                      std::shared_ptr<ClientOptions> client);
+  commitSubmissions();
 
   Name m_prefix;
   ndn::Face& m_face;
   Name m_topic;
   CtOptions m_options{m_topic};
-  ssize_t m_retryCount = 0;
 
   UpdateCallback m_onUpdate;
+  CommitCallback m_onCommit;
   Handle m_handle;
+  // submissions by name until acked, a repeated notification does not fetch them again
+  std::map<Name, std::shared_ptr<Submission>> m_inFlight;
+  std::vector<std::shared_ptr<Submission>> m_doneSubmissions;
+  ndn::Scheduler m_scheduler{m_face.getIoService()};
+  ndn::scheduler::ScopedEventId m_commitEvent;
+  ndn::util::SegmentFetcher::Options m_fetcherOptions;
 
   ndn::KeyChain& m_keyChain;
   ndn::security::Validator& m_validator;
+  ndn::security::SigningInfo m_signingInfo;
 };
 
 } // namespace ndnrevoke:append
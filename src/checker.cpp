@@ -1,10 +1,14 @@
 #include "checker.hpp"
 #include "record.hpp"
 #include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
 namespace ndnrevoke::checker {
 
 NDN_LOG_INIT(ndnrevoke.checker);
 
+const size_t Checker::MAX_BATCH_ROOTS = 1000;
+const size_t Checker::MAX_RANGES = 1000;
+
 Checker::Checker(ndn::Face& face, ndn::security::Validator& validator)
   : m_face(face)
   , m_validator(validator)
@@ -49,8 +53,33 @@ Checker::dispatchInterest(const std::shared_ptr<CheckerOptions>& checkerOptions,
     return checkerOptions->onFailure(Error(Error::Code::TIMEOUT, "Running out of retries"));
   }
 
-  m_face.expressInterest(*checkerOptions->makeInterest(ledgerPrefix, revoker),
-    [this, checkerOptions] (auto&&, auto& data) {
+  auto interest = checkerOptions->makeInterest(ledgerPrefix, revoker);
+  if (auto cached = makeCachedRangeNack(ledgerPrefix, *interest)) {
+    NDN_LOG_DEBUG("Cached range statement covers " << interest->getName());
+    return checkerOptions->onValid(nack::RecordNack(*cached));
+  }
+
+  m_face.expressInterest(*interest,
+    [this, checkerOptions, ledgerPrefix] (auto& i, auto& data) {
+      // a batched nack is covered by the signature of its batch root,
+      // a range nack by the signature of its range statement
+      if (nack::RecordNack::isValidName(data.getName())) {
+        optional<nack::BatchProof> proof;
+        optional<Data> statement;
+        try {
+          proof = nack::decodeBatchProof(data);
+          statement = nack::decodeRangeNack(data);
+        }
+        catch (const ndn::tlv::Error& e) {
+          return checkerOptions->onFailure(Error(Error::Code::PROTO_SPECIFIC, e.what()));
+        }
+        if (proof) {
+          return onBatchedNack(checkerOptions, ledgerPrefix, data, *proof);
+        }
+        if (statement) {
+          return onRangeNack(checkerOptions, ledgerPrefix, i, data, *statement);
+        }
+      }
       // naming conventiion check
       m_validator.validate(data,
         [this, checkerOptions, data] (const Data&) {
@@ -87,6 +116,136 @@ Checker::onValidationSuccess(const std::shared_ptr<CheckerOptions>& checkerOptio
   }
 }
 
+void
+Checker::onBatchedNack(const std::shared_ptr<CheckerOptions>& checkerOptions, const Name& ledgerPrefix,
+                       const Data& data, const nack::BatchProof& proof)
+{
+  if (!ndn::security::verifyDigest(data, ndn::DigestAlgorithm::SHA256)) {
+    return checkerOptions->onFailure(Error(Error::Code::VALIDATION_ERROR, "Batched nack digest mismatch"));
+  }
+  // only the roots of the CT asked, which the trust schema binds to the CT key, are fetched
+  Name batchPrefix = Name(ledgerPrefix).append("NACK-BATCH");
+  if (proof.rootName.size() != batchPrefix.size() + 1 || !batchPrefix.isPrefixOf(proof.rootName)) {
+    return checkerOptions->onFailure(Error(Error::Code::VALIDATION_ERROR,
+                                           "Nack batch root is not under " + batchPrefix.toUri()));
+  }
+  auto root = nack::computeMerkleRoot(nack::computeLeafDigest(data.getName()), proof.leafIndex, proof.path);
+  auto checkRoot = [checkerOptions, data, root] (const Buffer& signedRoot) {
+    if (signedRoot != root) {
+      return checkerOptions->onFailure(Error(Error::Code::VALIDATION_ERROR, "Nack is not in its signed batch"));
+    }
+    return checkerOptions->onValid(nack::RecordNack(data));
+  };
+
+  if (auto cached = m_batchRoots.find(proof.rootName)) {
+    return checkRoot(*cached);
+  }
+  Interest interest(proof.rootName);
+  interest.setCanBePrefix(false);
+  m_face.expressInterest(interest,
+    [this, checkerOptions, checkRoot] (auto&&, auto& rootData) {
+      m_validator.validate(rootData,
+        [this, checkRoot] (const Data& validated) {
+          NDN_LOG_DEBUG("Nack batch root conforms to trust schema");
+          Buffer signedRoot(validated.getContent().value_begin(), validated.getContent().value_end());
+          m_batchRoots.insert(validated.getName(), signedRoot);
+          return checkRoot(signedRoot);
+        },
+        [this, checkerOptions] (const Data&, const ndn::security::ValidationError& error) {
+          NDN_LOG_ERROR("Error authenticating nack batch root: " << error);
+          return onValidationFailure(checkerOptions, error);
+        }
+      );
+    },
+    [checkerOptions] (auto& i, auto&&) {
+      return checkerOptions->onFailure(Error(Error::Code::NACK, i.getName().toUri()));
+    },
+    [checkerOptions] (auto& i) {
+      return checkerOptions->onFailure(Error(Error::Code::TIMEOUT, "Cannot fetch nack batch root " + i.getName().toUri()));
+    }
+  );
+}
+
+void
+Checker::onRangeNack(const std::shared_ptr<CheckerOptions>& checkerOptions, const Name& ledgerPrefix,
+                     const Interest& interest, const Data& data, const Data& statement)
+{
+  if (!ndn::security::verifyDigest(data, ndn::DigestAlgorithm::SHA256)) {
+    return checkerOptions->onFailure(Error(Error::Code::VALIDATION_ERROR, "Range nack digest mismatch"));
+  }
+  // only the statements of the CT asked, which the trust schema binds to the CT key, count
+  Name rangePrefix = Name(ledgerPrefix).append("RANGE");
+  if (statement.getName().size() != rangePrefix.size() + 1 || !rangePrefix.isPrefixOf(statement.getName())) {
+    return checkerOptions->onFailure(Error(Error::Code::VALIDATION_ERROR,
+                                           "Range statement is not under " + rangePrefix.toUri()));
+  }
+  nack::RangeStatement range;
+  try {
+    range = nack::decodeRangeStatement(statement);
+  }
+  catch (const ndn::tlv::Error& e) {
+    return checkerOptions->onFailure(Error(Error::Code::PROTO_SPECIFIC, e.what()));
+  }
+  if (!range.covers(interest.getName(), interest.getCanBePrefix())) {
+    return checkerOptions->onFailure(Error(Error::Code::VALIDATION_ERROR, "Range statement does not cover the query"));
+  }
+  // the version of a statement is its signing time, a statement past its freshness may
+  // predate a record stored in the range since
+  const auto& version = statement.getName().get(-1);
+  if (!version.isVersion()) {
+    return checkerOptions->onFailure(Error(Error::Code::PROTO_SPECIFIC, "Range statement has no version"));
+  }
+  auto now = time::system_clock::now();
+  auto expiry = time::fromUnixTimestamp(time::milliseconds(version.toVersion())) + statement.getFreshnessPeriod();
+  if (expiry <= now) {
+    return checkerOptions->onFailure(Error(Error::Code::VALIDATION_ERROR, "Range statement is stale"));
+  }
+  auto remaining = std::min<time::nanoseconds>(expiry - now, statement.getFreshnessPeriod());
+
+  m_validator.validate(statement,
+    [this, checkerOptions, ledgerPrefix, data, range, remaining] (const Data& validated) {
+      NDN_LOG_DEBUG("Range statement conforms to trust schema");
+      m_ranges.insert(makeRangeKey(ledgerPrefix, range.lower ? *range.lower : range.zone),
+                      CachedRange{range, validated, time::steady_clock::now() + remaining});
+      return checkerOptions->onValid(nack::RecordNack(data));
+    },
+    [this, checkerOptions] (const Data&, const ndn::security::ValidationError& error) {
+      NDN_LOG_ERROR("Error authenticating range statement: " << error);
+      return onValidationFailure(checkerOptions, error);
+    }
+  );
+}
+
+Name
+Checker::makeRangeKey(const Name& ledgerPrefix, const Name& name)
+{
+  // the ledger prefix as one component, so that the ranges of a CT stay contiguous
+  return Name().append(Name::Component(ledgerPrefix.wireEncode())).append(name);
+}
+
+optional<Data>
+Checker::makeCachedRangeNack(const Name& ledgerPrefix, const Interest& interest)
+{
+  const Name& name = interest.getName();
+  auto key = makeRangeKey(ledgerPrefix, name);
+  auto range = m_ranges.findFloor(key);
+  if (range.second == nullptr || range.first->get(0) != key.get(0)) {
+    return nullopt;
+  }
+  if (time::steady_clock::now() >= range.second->expiry) {
+    m_ranges.erase(Name(*range.first));
+    return nullopt;
+  }
+  if (!range.second->statement.covers(name, interest.getCanBePrefix())) {
+    return nullopt;
+  }
+  // the nack is as old as the statement, whose version is its signing time
+  nack::Nack nack;
+  auto data = nack.prepareData(name, time::milliseconds(range.second->data.getName().get(-1).toVersion()));
+  data->setContent(nack::encodeRangeNack(range.second->data));
+  return *data;
+}
+
 void
 Checker::onValidationFailure(const std::shared_ptr<CheckerOptions>& checkerOptions, const ndn::security::ValidationError& error)
 {
@@ -3,6 +3,9 @@
 
 #include "record.hpp"
 #include "nack.hpp"
+#include "nack-batch.hpp"
+#include "nack-range.hpp"
+#include "name-lru-map.hpp"
 #include "error.hpp"
 #include "checker-options.hpp"
 #include <ndn-cxx/security/key-chain.hpp>
@@ -44,8 +47,53 @@ private:
 
   void
   onValidationFailure(const std::shared_ptr<CheckerOptions>& checkerOptions, const ndn::security::ValidationError& error);
+
+  /**
+   * @brief Accept a batched nack once its batch root, named under @p ledgerPrefix, is fetched
+   *        and validated, and the inclusion proof of the nack leads to that root.
+   */
+  void
+  onBatchedNack(const std::shared_ptr<CheckerOptions>& checkerOptions, const Name& ledgerPrefix,
+                const Data& data, const nack::BatchProof& proof);
+
+  /**
+   * @brief Accept a range nack once its range statement, named under @p ledgerPrefix, is
+   *        validated and covers the query, and keep the statement to answer later checks
+   *        in the same range.
+   */
+  void
+  onRangeNack(const std::shared_ptr<CheckerOptions>& checkerOptions, const Name& ledgerPrefix,
+              const Interest& interest, const Data& data, const Data& statement);
+
+  static Name
+  makeRangeKey(const Name& ledgerPrefix, const Name& name);
+
+  /**
+   * @return a nack to @p interest from a cached range statement of @p ledgerPrefix covering it,
+   *         or nullopt
+   */
+  optional<Data>
+  makeCachedRangeNack(const Name& ledgerPrefix, const Interest& interest);
+
+public:
+  // validated batch roots kept to check later nacks of the same batches
+  static const size_t MAX_BATCH_ROOTS;
+  // validated range statements kept to answer later checks
+  static const size_t MAX_RANGES;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   ndn::Face& m_face;
   ndn::security::Validator& m_validator;
+  NameLruMap<Buffer> m_batchRoots{MAX_BATCH_ROOTS};
+
+  struct CachedRange
+  {
+    nack::RangeStatement statement;
+    Data data;
+    time::steady_clock::time_point expiry;
+  };
+  // by ledger prefix, then by lower bound, or by zone for the first range of a zone
+  NameLruMap<CachedRange> m_ranges{MAX_RANGES};
 };
 
 } // namespace ndnrevoke::checker
@@ -9,9 +9,39 @@ namespace ndnrevoke::ct {
 
 const std::string CONFIG_CT_PREFIX = "ct-prefix";
 const std::string CONFIG_NACK_FRESHNESS_PERIOD = "nack-freshness-period";
+const std::string CONFIG_NACK_CACHE_CAPACITY = "nack-cache-capacity";
+const std::string CONFIG_NACK_BATCH_WINDOW = "nack-batch-window";
+const std::string CONFIG_NACK_RANGES = "nack-ranges";
 const std::string CONFIG_RECORD_ZONES = "record-zones";
 const std::string CONFIG_RECORD_ZONE_PREFIX = "record-zone-prefix";
 const std::string CONFIG_TRUST_SCHEMA = "trust-schema";
+const std::string CONFIG_VALIDATOR_WORKERS = "validator-workers";
+const std::string CONFIG_STORAGE_TYPE = "storage-type";
+const std::string CONFIG_STORAGE_PATH = "storage-path";
+const std::string CONFIG_NEGATIVE_FILTER_CAPACITY = "negative-filter-capacity";
+const std::string CONFIG_CACHE_CAPACITY = "cache-capacity";
+const std::string CONFIG_RECORD_RETENTION = "record-retention";
+const std::string CONFIG_ZONE_QUOTA = "zone-quota";
+const std::string CONFIG_RECORD_ZONE_QUOTA = "quota";
+const std::string CONFIG_SIGNING = "signing";
+const std::string CONFIG_SIGNING_NACK = "nack";
+const std::string CONFIG_SIGNING_ACK = "ack";
+const std::string CONFIG_SIGNING_INDEX = "index";
+
+static ndn::security::SigningInfo
+parseSigning(const JsonSection& configJson, const std::string& messageClass, const Name& ctPrefix)
+{
+  auto signing = configJson.get(CONFIG_SIGNING + "." + messageClass, "");
+  if (signing.empty()) {
+    return ndn::signingByIdentity(ctPrefix);
+  }
+  try {
+    return ndn::security::SigningInfo(signing);
+  }
+  catch (const std::invalid_argument& e) {
+    NDN_THROW(std::runtime_error("Cannot parse the signing of " + messageClass + ": " + e.what()));
+  }
+}
 
 void
 CtConfig::load(const std::string& fileName)
@@ -35,8 +65,13 @@ CtConfig::load(const std::string& fileName)
   }
   // Nack Freshness Period
   nackFreshnessPeriod = time::seconds(configJson.get(CONFIG_NACK_FRESHNESS_PERIOD, 86400));
+  nackCacheCapacity = configJson.get<size_t>(CONFIG_NACK_CACHE_CAPACITY, 10000);
+  nackBatchWindow = time::milliseconds(configJson.get(CONFIG_NACK_BATCH_WINDOW, 0));
+  nackRanges = configJson.get<bool>(CONFIG_NACK_RANGES, false);
   // Record Zones
   recordZones.clear();
+  zoneQuotas.clear();
+  auto defaultQuota = configJson.get<uint64_t>(CONFIG_ZONE_QUOTA, 0);
   auto recordZonePrefixJson = configJson.get_child_optional(CONFIG_RECORD_ZONES);
   if (recordZonePrefixJson) {
     for (const auto& item : *recordZonePrefixJson) {
@@ -45,6 +80,7 @@ CtConfig::load(const std::string& fileName)
         NDN_THROW(std::runtime_error("recordZonePrefix cannot be empty."));
       }
       recordZones.push_back(Name(recordZonePrefix));
+      zoneQuotas[recordZones.back()] = item.second.get<uint64_t>(CONFIG_RECORD_ZONE_QUOTA, defaultQuota);
     }
   }
   else {
@@ -55,6 +91,21 @@ CtConfig::load(const std::string& fileName)
   if (schemaFile.empty()) {
     NDN_THROW(std::runtime_error("Cannot parse trust schema from the config file"));
   }
+  validatorWorkers = configJson.get<size_t>(CONFIG_VALIDATOR_WORKERS, 0);
+
+  // Storage
+  storageType = configJson.get(CONFIG_STORAGE_TYPE, "ct-storage-memory");
+  storagePath = configJson.get(CONFIG_STORAGE_PATH, "");
+  negativeFilterCapacity = configJson.get<size_t>(CONFIG_NEGATIVE_FILTER_CAPACITY, 1000000);
+  cacheCapacity = configJson.get<size_t>(CONFIG_CACHE_CAPACITY, 10000);
+
+  // Expiry
+  recordRetention = time::seconds(configJson.get(CONFIG_RECORD_RETENTION, 0));
+
+  // Signing
+  nackSigning = parseSigning(configJson, CONFIG_SIGNING_NACK, ctPrefix);
+  ackSigning = parseSigning(configJson, CONFIG_SIGNING_ACK, ctPrefix);
+  indexSigning = parseSigning(configJson, CONFIG_SIGNING_INDEX, ctPrefix);
 }
 
 } // namespace ndnrevoke::ct
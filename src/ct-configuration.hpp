@@ -14,12 +14,34 @@ namespace ndnrevoke::ct {
  * {
  *  "ct-prefix": "",
  *  "nack-freshness-period": "", (in seconds)
+ *  "nack-cache-capacity": "", (optional, default 10000, 0 to disable)
+ *  "nack-batch-window": "", (optional, in milliseconds, default 0 to sign every nack)
+ *  "nack-ranges": "", (optional, default false, true to answer misses with signed range statements)
  *  "record-zones":
  *  [
  *    {"record-zone-prefix": ""},
- *    {"record-zone-prefix": ""}
- *  ]
+ *    {"record-zone-prefix": "", "quota": ""} (optional, in bytes, overrides "zone-quota")
+ *  ],
+ *  "trust-schema": "",
+ *  "validator-workers": "", (optional, threads validating submissions, default 0 for the I/O thread)
+ *  "storage-type": "", (optional, default "ct-storage-memory")
+ *  "storage-path": "", (optional, backend specific)
+ *  "negative-filter-capacity": "", (optional, default 1000000, 0 to disable)
+ *  "cache-capacity": "", (optional, default 10000, for "ct-storage-cached:<inner>" storage types)
+ *  "record-retention": "", (optional, in seconds, for records that are neither certificates nor
+ *                          revocation records, default 0 to keep such records forever)
+ *  "zone-quota": "", (optional, bytes of records per record zone, default 0 for no quota)
+ *  "signing": (optional, per message class, default "id:<ct-prefix>")
+ *  {
+ *    "nack": "", (nacks)
+ *    "ack": "", (append acks)
+ *    "index": "" (index replies)
+ *  }
  * }
+ *
+ * A signing is given in ndn::security::SigningInfo format, e.g., "key:<key-name>" for an
+ * Ed25519 key, "hmac-sha256:<base64-key>" for a trusted local link, or
+ * "id:/localhost/identity/digest-sha256" for intra-cluster traffic.
  */
 class CtConfig
 {
@@ -34,11 +56,36 @@ public:
 public:
   Name ctPrefix;
   ndn::time::milliseconds nackFreshnessPeriod;
+  // signed nacks kept for reuse
+  size_t nackCacheCapacity;
+  // nacks produced within a window share one signature over their Merkle root
+  ndn::time::milliseconds nackBatchWindow;
+  // a miss is answered with a statement covering the gap between the adjacent stored names
+  bool nackRanges;
   // operator should list the namespace(s) that this Ct is responsible of.
   // Ct won't do look up for records that are that belong to any of the record Zone.
   // no protocol side impact, purely for filtering Ct side unnecessary record look up.
   std::vector<Name> recordZones;
   std::string schemaFile;
+  size_t validatorWorkers;
+  // storage backend registered through NDNREVOKE_REGISTER_CT_STORAGE
+  std::string storageType;
+  // backend specific location, empty for the backend's default
+  std::string storagePath;
+  // expected number of entries per record zone, used to size the negative lookup filters;
+  // a record takes one entry per name component below its zone
+  size_t negativeFilterCapacity;
+  // entries of each lookup cache of a cached storage
+  size_t cacheCapacity;
+  // how long a record is kept when the validity of its certificate is unknown
+  ndn::time::seconds recordRetention;
+  // maximum size of the records of each record zone, in bytes of wire encoding; 0 for no quota
+  std::map<Name, uint64_t> zoneQuotas;
+  // how each class of CT produced Data is signed; batch roots and range statements are
+  // always signed with the CT identity, which the trust schema binds them to
+  ndn::security::SigningInfo nackSigning;
+  ndn::security::SigningInfo ackSigning;
+  ndn::security::SigningInfo indexSigning;
 };
 
 } // namespace ndnrevoke::ct
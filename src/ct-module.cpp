@@ -1,6 +1,8 @@
 #include "ct-module.hpp"
 #include "record.hpp"
 #include "nack.hpp"
+#include "nack-batch.hpp"
+#include "nack-range.hpp"
 
 #include <ndn-cxx/security/signing-helpers.hpp>
 #include <ndn-cxx/security/verification-helpers.hpp>
@@ -12,19 +14,71 @@ namespace ndnrevoke::ct {
 
 NDN_LOG_INIT(ndnrevoke.ct);
 
+const time::milliseconds CtModule::EXPIRY_TICK = 1_s;
+const size_t CtModule::EXPIRY_SLOTS = 3600;
+const size_t CtModule::SWEEP_BUDGET = 1000;
+const size_t CtModule::LOAD_BUDGET = 1000;
+const size_t CtModule::MAX_INDEX_RESULTS = 32;
+const size_t CtModule::MAX_BATCH_ROOTS = 100000;
+
+/**
+ * @brief Insert @p name and its prefixes under @p zone, so that CanBePrefix queries
+ *        for any of them are not definite misses.
+ */
+static void
+insertNamePrefixes(CountingBloomFilter& filter, const Name& zone, const Name& name)
+{
+  for (size_t i = zone.size(); i <= name.size(); i++) {
+    filter.insert(CtStorage::computeNameDigest(name.getPrefix(i)));
+  }
+}
+
+/**
+ * @brief Erase @p name and its prefixes under @p zone, undoing insertNamePrefixes.
+ */
+static void
+eraseNamePrefixes(CountingBloomFilter& filter, const Name& zone, const Name& name)
+{
+  for (size_t i = zone.size(); i <= name.size(); i++) {
+    filter.erase(CtStorage::computeNameDigest(name.getPrefix(i)));
+  }
+}
+
 CtModule::CtModule(ndn::Face& face, ndn::KeyChain& keyChain, const std::string& configPath, const std::string& storageType)
   : m_face(face)
   , m_keyChain(keyChain)
 {
   // load the config and create storage
   m_config.load(configPath);
-  m_storage = CtStorage::createCtStorage(storageType, m_config.ctPrefix, "");
+  auto type = storageType.empty() ? m_config.storageType : storageType;
+  m_storage = CtStorage::createCtStorage(type, m_config.ctPrefix, m_config.storagePath,
+                                         {{"cache-capacity", std::to_string(m_config.cacheCapacity)}});
+  if (m_storage == nullptr) {
+    NDN_THROW(std::runtime_error("Unrecognized CT storage type: " + type));
+  }
+  // signing keys are looked up once, not on every nack and ack
+  m_nackSigner = m_signingKeys.resolve(m_config.nackSigning);
+  m_statementSigner = m_signingKeys.resolve(ndn::security::signingByIdentity(m_config.ctPrefix));
+  m_indexSigner = m_signingKeys.resolve(m_config.indexSigning);
+  auto ackSigner = m_signingKeys.resolve(m_config.ackSigning);
+  if (m_config.nackCacheCapacity > 0) {
+    m_nackCache = std::make_unique<NackCache>(m_config.nackCacheCapacity, m_config.nackFreshnessPeriod);
+    m_ranges = std::make_unique<NameLruMap<RangeEntry>>(m_config.nackCacheCapacity);
+  }
+  initZoneFilters();
+  initRecords();
   m_validator.load(m_config.schemaFile);
+  if (m_config.validatorWorkers > 0) {
+    m_validatorPool = std::make_unique<ValidatorPool>(m_face.getIoService(), m_config.schemaFile,
+                                                      m_config.validatorWorkers);
+  }
   registerPrefix();
   
   Name topic = Name(m_config.ctPrefix).append("LEDGER").append("append");
-  m_appendCt = std::make_unique<append::Ct>(m_config.ctPrefix, topic, m_face, m_keyChain, m_validator);
-  m_appendCt->listen(std::bind(&CtModule::onDataSubmission, this, _1));
+  m_appendCt = std::make_unique<append::Ct>(m_config.ctPrefix, topic, m_face, ackSigner.getKeyChain(), m_validator);
+  m_appendCt->setSigningInfo(ackSigner.getSigningInfo());
+  m_appendCt->listen(std::bind(&CtModule::onDataSubmission, this, _1, _2, _3),
+                     std::bind(&CtModule::onSubmissionCommit, this));
 }
 
 void
@@ -45,34 +99,119 @@ CtModule::registerPrefix()
         NDN_LOG_TRACE("Registering filter for recordZone " << zone);
         m_handle.handleFilter(filterId);
       }
+      auto filterId = m_face.setInterestFilter(Name(name).append("INDEX"),
+                                               [this] (auto&&, const auto& i) { onIndexQuery(i); });
+      m_handle.handleFilter(filterId);
+      if (m_config.nackBatchWindow > 0_ms) {
+        filterId = m_face.setInterestFilter(Name(name).append("NACK-BATCH"),
+                                            [this] (auto&&, const auto& i) { onBatchRootQuery(i); });
+        m_handle.handleFilter(filterId);
+      }
     },
     [this] (auto&&, const auto& reason) { onRegisterFailed(reason); }
   );
   m_handle.handlePrefix(prefixId);
 }
 
-AppendStatus 
-CtModule::onDataSubmission(const Data& data)
+void
+CtModule::onDataSubmission(const Name& submission, const Data& data, const append::UpdateDoneCallback& done)
 {
   NDN_LOG_TRACE("Received Submission " << data);
-  AppendStatus ret;
-  m_validator.validate(data,
-    [this, &data, &ret] (const Data&) {
-      NDN_LOG_TRACE("Submitted Data conforms to trust schema");
-      try {
-        m_storage->addData(data);
-        ret = AppendStatus::SUCCESS;
-      }
-      catch (std::exception& e) {
-        NDN_LOG_TRACE("Submission failed because of: " << e.what());
-        ret = AppendStatus::FAILURE_STORAGE;
+  auto update = std::make_shared<PendingUpdate>();
+  update->done = done;
+  m_pendingUpdates[submission].push_back(update);
+
+  // validation may fetch certificates, other submissions are served meanwhile
+  auto onValid = [this, update, submission] (const Data& validated) {
+    NDN_LOG_TRACE("Submitted Data conforms to trust schema");
+    update->isValidated = true;
+    update->data = validated;
+    applyUpdates(submission);
+  };
+  auto onInvalid = [this, update, submission] (const Data&, const ndn::security::ValidationError& error) {
+    NDN_LOG_ERROR("Error authenticating data: " << error);
+    update->isValidated = true;
+    applyUpdates(submission);
+  };
+  if (m_validatorPool != nullptr) {
+    m_validatorPool->validate(data, onValid, onInvalid);
+  }
+  else {
+    m_validator.validate(data, onValid, onInvalid);
+  }
+}
+
+void
+CtModule::applyUpdates(const Name& submission)
+{
+  // quotas count the loaded records only, loadRecords() applies the updates once all are
+  if (isLoadingRecords()) {
+    return;
+  }
+  auto queue = m_pendingUpdates.find(submission);
+  if (queue == m_pendingUpdates.end()) {
+    return;
+  }
+  auto& updates = queue->second;
+  while (!updates.empty() && updates.front()->isValidated) {
+    auto update = std::move(updates.front());
+    updates.pop_front();
+    update->done(storeSubmission(update->data));
+  }
+  if (updates.empty()) {
+    m_pendingUpdates.erase(queue);
+  }
+}
+
+AppendStatus
+CtModule::storeSubmission(const optional<Data>& data)
+{
+  if (!data) {
+    return AppendStatus::FAILURE_VALIDATION_APP;
+  }
+  // the quota is checked when the Data is stored, after the Data submitted before it
+  if (isOverQuota(*data)) {
+    NDN_LOG_DEBUG("Submission rejected, the zone of " << data->getName() << " is over its quota");
+    return AppendStatus::FAILURE_QUOTA;
+  }
+  try {
+    storeData(*data);
+  }
+  catch (std::exception& e) {
+    NDN_LOG_TRACE("Submission failed because of: " << e.what());
+    return AppendStatus::FAILURE_STORAGE;
+  }
+  m_uncommittedRecords.push_back(*data);
+  return AppendStatus::SUCCESS;
+}
+
+bool
+CtModule::onSubmissionCommit()
+{
+  auto records = std::move(m_uncommittedRecords);
+  m_uncommittedRecords.clear();
+  try {
+    m_storage->commit();
+    return true;
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("CT storage cannot commit submissions: " << e.what());
+  }
+  // newest first; the storage may have dropped the records with the failed commit already
+  for (auto record = records.rbegin(); record != records.rend(); ++record) {
+    const Name& name = record->getName();
+    try {
+      if (m_storage->findData(name) != nullptr) {
+        m_storage->deleteData(name);
       }
-    },
-    [&ret] (const Data&, const ndn::security::ValidationError& error) {
-      NDN_LOG_ERROR("Error authenticating data: " << error);
-      ret = AppendStatus::FAILURE_VALIDATION_APP;
-    });
-  return ret;
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("CT storage cannot roll back " << name << ": " << e.what());
+    }
+    forgetData(name, &*record);
+  }
+  NDN_LOG_DEBUG("Rolled back " << records.size() << " uncommitted records");
+  return false;
 }
 
 void
@@ -84,21 +223,598 @@ CtModule::onQuery(const Interest& query) {
   }
 
   NDN_LOG_TRACE("Received Query " << query);
+  if (isDefiniteMiss(query.getName())) {
+    replyNack(query);
+    return;
+  }
+
+  std::shared_ptr<const Data> data;
   try {
-    Data data = m_storage->getData(query.getName());
-    NDN_LOG_TRACE("CT replies with: " << data.getName());
-    m_face.put(data);
+    data = query.getCanBePrefix() ? m_storage->findLatestData(query.getName()) :
+                                    m_storage->findData(query.getName());
   }
-  catch (std::exception& e) {
-    NDN_LOG_DEBUG("CT storage cannot get the Data for reason: " << e.what());
-    // reply with app layer nack
-    nack::Nack nack;
-    auto data = nack.prepareData(query.getName(), time::toUnixTimestamp(time::system_clock::now()));
-    data->setFreshnessPeriod(m_config.nackFreshnessPeriod);
-    m_keyChain.sign(*data, signingByIdentity(m_config.ctPrefix));
-    NDN_LOG_TRACE("CT replies with: " << data->getName());
-    m_face.put(*data);
+  catch (const std::exception& e) {
+    // a nack would state that the record does not exist, let the query time out instead
+    NDN_LOG_ERROR("CT storage cannot look up " << query.getName() << ": " << e.what());
+    return;
+  }
+  if (data == nullptr) {
+    replyNack(query);
+    return;
+  }
+  NDN_LOG_TRACE("CT replies with: " << data->getName());
+  m_face.put(*data);
+}
+
+void
+CtModule::onIndexQuery(const Interest& query)
+{
+  // /<ct-prefix>/LEDGER/INDEX/<kind>/<value>[/<after>]
+  const Name& name = query.getName();
+  Name indexPrefix = Name(m_config.ctPrefix).append("LEDGER").append("INDEX");
+  size_t kindOffset = indexPrefix.size();
+  if (name.size() < kindOffset + 2 || name.size() > kindOffset + 3 || !indexPrefix.isPrefixOf(name)) {
+    return;
+  }
+  auto kind = CtIndex::parseKind(name.get(kindOffset));
+  if (!kind) {
+    NDN_LOG_TRACE("Unknown index in query " << name);
+    return;
+  }
+  if (isLoadingRecords()) {
+    // a nack would state that no record matches, let the query time out instead
+    NDN_LOG_DEBUG("Records are still loading, index query " << name << " is not answered");
+    return;
+  }
+  optional<Name> after;
+  if (name.size() == kindOffset + 3) {
+    const auto& component = name.get(kindOffset + 2);
+    try {
+      after = Name(Block(make_span(component.value(), component.value_size())));
+    }
+    catch (const ndn::tlv::Error& e) {
+      NDN_LOG_TRACE("Malformed page in query " << name << ": " << e.what());
+      return;
+    }
+  }
+
+  // one more name tells whether another page follows
+  auto names = m_index.find(*kind, name.get(kindOffset + 1), MAX_INDEX_RESULTS + 1, after);
+  if (names.empty()) {
+    replyNack(query);
+    return;
+  }
+  bool hasMore = names.size() > MAX_INDEX_RESULTS;
+  if (hasMore) {
+    names.pop_back();
+  }
+  Block content(ndn::tlv::Content);
+  for (const auto& recordName : names) {
+    content.push_back(recordName.wireEncode());
+  }
+  if (hasMore) {
+    const auto& last = names.back().wireEncode();
+    Name next = name.getPrefix(kindOffset + 2).append(Name::Component(make_span(last.wire(), last.size())));
+    content.push_back(makeNestedBlock(tlv::IndexNextPage, next));
+  }
+  content.encode();
+
+  auto data = std::make_shared<Data>(Name(name).appendTimestamp(time::system_clock::now()));
+  data->setContent(content);
+  data->setFreshnessPeriod(m_config.nackFreshnessPeriod);
+  m_indexSigner.sign(*data);
+  NDN_LOG_TRACE("CT replies with: " << data->getName());
+  m_face.put(*data);
+}
+
+void
+CtModule::replyNack(const Interest& query)
+{
+  if (m_config.nackRanges && replyRangeNack(query)) {
+    return;
+  }
+  const Name& name = query.getName();
+  bool canBePrefix = query.getCanBePrefix();
+  if (m_nackCache != nullptr) {
+    if (auto entry = m_nackCache->find(name, canBePrefix)) {
+      if (m_nackCache->needsRefresh(*entry)) {
+        m_nackCache->markRefreshing(name, canBePrefix);
+        requestNack(name, canBePrefix, true);
+      }
+      auto reply = m_nackCache->makeReply(name, canBePrefix, [this] (Data& data) {
+        // batched nacks carry their proof and are only digested
+        if (m_config.nackBatchWindow > 0_ms) {
+          m_keyChain.sign(data, ndn::signingWithSha256());
+        }
+        else {
+          m_nackSigner.sign(data);
+        }
+      });
+      NDN_LOG_TRACE("CT replies with cached: " << reply->getName());
+      m_face.put(*reply);
+      return;
+    }
+  }
+  requestNack(name, canBePrefix, false);
+}
+
+std::shared_ptr<const Data>
+CtModule::makeNack(const Name& name)
+{
+  // reply with app layer nack
+  nack::Nack nack;
+  auto data = nack.prepareData(name, time::toUnixTimestamp(time::system_clock::now()));
+  data->setFreshnessPeriod(m_config.nackFreshnessPeriod);
+  m_nackSigner.sign(*data);
+  return data;
+}
+
+void
+CtModule::requestNack(const Name& name, bool canBePrefix, bool isRefresh)
+{
+  if (m_config.nackBatchWindow > 0_ms) {
+    m_pendingNacks.push_back({name, canBePrefix, isRefresh});
+    if (m_pendingNacks.size() == 1) {
+      m_nackBatchEvent = m_scheduler.schedule(m_config.nackBatchWindow, [this] { flushNackBatch(); });
+    }
+    return;
+  }
+  if (isRefresh) {
+    // sign the replacement of a hot nack after the pending queries are served
+    m_scheduler.schedule(0_ms, [this, name, canBePrefix] {
+      deliverNack(name, canBePrefix, true, makeNack(name));
+    });
+    return;
+  }
+  deliverNack(name, canBePrefix, false, makeNack(name));
+}
+
+void
+CtModule::deliverNack(const Name& name, bool canBePrefix, bool isRefresh, std::shared_ptr<const Data> nack,
+                      std::shared_ptr<const Data> root)
+{
+  if (isRefresh) {
+    m_nackCache->refresh(name, canBePrefix, std::move(nack), std::move(root));
+    return;
+  }
+  if (m_nackCache != nullptr) {
+    m_nackCache->insert(name, canBePrefix, nack, std::move(root));
+  }
+  NDN_LOG_TRACE("CT replies with: " << nack->getName());
+  m_face.put(*nack);
+}
+
+void
+CtModule::flushNackBatch()
+{
+  auto pending = std::move(m_pendingNacks);
+  m_pendingNacks.clear();
+  if (pending.empty()) {
+    return;
+  }
+
+  // one nack per name, shared by the queries for that name
+  auto timestamp = time::toUnixTimestamp(time::system_clock::now());
+  std::map<Name, size_t> leafIndexes;
+  std::vector<std::shared_ptr<Data>> nacks;
+  std::vector<Buffer> leaves;
+  for (const auto& item : pending) {
+    if (leafIndexes.emplace(item.name, nacks.size()).second) {
+      nack::Nack nack;
+      nacks.push_back(nack.prepareData(item.name, timestamp));
+      nacks.back()->setFreshnessPeriod(m_config.nackFreshnessPeriod);
+      leaves.push_back(nack::computeLeafDigest(nacks.back()->getName()));
+    }
+  }
+  std::vector<std::vector<Buffer>> paths;
+  auto root = nack::buildMerkleTree(leaves, paths);
+
+  // the only signature of the batch
+  m_lastBatchVersion = std::max<uint64_t>(m_lastBatchVersion + 1, timestamp.count());
+  Name rootName = Name(m_config.ctPrefix).append("LEDGER").append("NACK-BATCH").appendVersion(m_lastBatchVersion);
+  auto rootData = std::make_shared<Data>(rootName);
+  rootData->setContent(root);
+  rootData->setFreshnessPeriod(m_config.nackFreshnessPeriod);
+  m_statementSigner.sign(*rootData);
+  m_batchRoots.emplace(m_lastBatchVersion, rootData);
+
+  // a root stays available as long as the nacks of its batch can be reused; past the bound
+  // on roots, only as long as a cached nack still refers to it
+  auto oldest = static_cast<uint64_t>((timestamp - m_config.nackFreshnessPeriod).count());
+  while (m_batchRoots.size() > MAX_BATCH_ROOTS || m_batchRoots.begin()->first < oldest) {
+    auto evicted = m_batchRoots.begin();
+    if (evicted->first >= oldest && evicted->second.use_count() > 1) {
+      m_pinnedBatchRoots.emplace(evicted->first, evicted->second);
+    }
+    m_batchRoots.erase(evicted);
+  }
+  while (!m_pinnedBatchRoots.empty() && (m_pinnedBatchRoots.begin()->first < oldest ||
+                                         m_pinnedBatchRoots.begin()->second.expired())) {
+    m_pinnedBatchRoots.erase(m_pinnedBatchRoots.begin());
+  }
+
+  for (size_t i = 0; i < nacks.size(); i++) {
+    nacks[i]->setContent(nack::encodeBatchProof({rootName, i, paths[i]}));
+    m_keyChain.sign(*nacks[i], ndn::signingWithSha256());
+  }
+  NDN_LOG_TRACE("Signed a batch of " << nacks.size() << " nacks as " << rootName);
+  for (const auto& item : pending) {
+    deliverNack(item.name, item.canBePrefix, item.isRefresh, nacks[leafIndexes[item.name]], rootData);
+  }
+}
+
+void
+CtModule::onBatchRootQuery(const Interest& query)
+{
+  // /<ct-prefix>/LEDGER/NACK-BATCH/<version>
+  const Name& name = query.getName();
+  if (name.empty() || !name.get(-1).isVersion()) {
+    return;
+  }
+  auto root = findBatchRoot(name.get(-1).toVersion());
+  if (root == nullptr || root->getName() != name) {
+    return;
+  }
+  m_face.put(*root);
+}
+
+std::shared_ptr<const Data>
+CtModule::findBatchRoot(uint64_t version)
+{
+  auto root = m_batchRoots.find(version);
+  if (root != m_batchRoots.end()) {
+    return root->second;
+  }
+  auto pinned = m_pinnedBatchRoots.find(version);
+  if (pinned == m_pinnedBatchRoots.end()) {
+    return nullptr;
+  }
+  auto data = pinned->second.lock();
+  if (data == nullptr) {
+    m_pinnedBatchRoots.erase(pinned);
+  }
+  return data;
+}
+
+bool
+CtModule::replyRangeNack(const Interest& query)
+{
+  const Name& name = query.getName();
+  auto zone = findZone(name);
+  if (zone == nullptr) {
+    return false;
+  }
+  RangeEntry range;
+  try {
+    range = findRangeStatement(*zone, name, query.getCanBePrefix());
+  }
+  catch (const std::exception& e) {
+    // same as a failed lookup, let the query time out
+    NDN_LOG_ERROR("CT storage cannot look up the range of " << name << ": " << e.what());
+    return true;
+  }
+
+  // the statement carries the signature, the nack only binds it to the query
+  nack::Nack nack;
+  auto data = nack.prepareData(name, time::toUnixTimestamp(time::system_clock::now()));
+  data->setContent(nack::encodeRangeNack(*range.data));
+  auto remaining = range.signedAt + m_config.nackFreshnessPeriod - time::steady_clock::now();
+  data->setFreshnessPeriod(time::duration_cast<time::milliseconds>(remaining));
+  m_keyChain.sign(*data, ndn::signingWithSha256());
+  NDN_LOG_TRACE("CT replies with: " << data->getName() << " in " << range.data->getName());
+  m_face.put(*data);
+  return true;
+}
+
+CtModule::RangeEntry
+CtModule::findRangeStatement(const Name& zone, const Name& name, bool canBePrefix)
+{
+  auto now = time::steady_clock::now();
+  auto reuse = time::duration_cast<time::milliseconds>(m_config.nackFreshnessPeriod * NackCache::REUSE_RATIO);
+  // ranges never overlap, only the last one starting before name may cover it
+  if (m_ranges != nullptr) {
+    auto cached = m_ranges->findFloor(name).second;
+    if (cached != nullptr && cached->statement.covers(name, canBePrefix) && now < cached->signedAt + reuse) {
+      return *cached;
+    }
+  }
+
+  RangeEntry range;
+  range.statement.zone = zone;
+  range.statement.lower = m_storage->findPrecedingName(zone, name);
+  auto following = m_storage->listNames(zone, name, 1);
+  if (!following.empty()) {
+    range.statement.upper = following.front();
+  }
+
+  auto timestamp = time::toUnixTimestamp(time::system_clock::now());
+  m_lastRangeVersion = std::max<uint64_t>(m_lastRangeVersion + 1, timestamp.count());
+  auto data = std::make_shared<Data>(Name(m_config.ctPrefix).append("LEDGER").append("RANGE")
+                                                            .appendVersion(m_lastRangeVersion));
+  data->setContent(nack::encodeRangeStatement(range.statement));
+  data->setFreshnessPeriod(m_config.nackFreshnessPeriod);
+  m_statementSigner.sign(*data);
+  NDN_LOG_TRACE("Signed range statement " << data->getName() << " for " << name);
+  range.data = data;
+  range.signedAt = now;
+
+  if (m_ranges != nullptr) {
+    m_ranges->insert(range.statement.lower ? *range.statement.lower : zone, range);
+  }
+  return range;
+}
+
+void
+CtModule::storeData(const Data& data)
+{
+  auto expiry = getExpiry(data);
+  m_storage->addData(data);
+  for (auto& filter : m_zoneFilters) {
+    if (filter.first.isPrefixOf(data.getName())) {
+      insertNamePrefixes(filter.second, filter.first, data.getName());
+    }
+  }
+  // a record not loaded yet is indexed, accounted and scheduled to expire when its zone is
+  bool isLoaded = isRecordLoaded(data.getName());
+  if (isLoaded) {
+    m_index.insert(data);
+  }
+  if (m_nackCache != nullptr) {
+    m_nackCache->invalidate(data.getName());
+  }
+  // the range around the new record no longer holds
+  if (m_ranges != nullptr) {
+    auto range = m_ranges->findFloor(data.getName());
+    if (range.second != nullptr && range.second->statement.covers(data.getName(), false)) {
+      m_ranges->erase(Name(*range.first));
+    }
+  }
+  // pending nacks are not sent, their queries are retried and find the record
+  const Name& name = data.getName();
+  m_pendingNacks.erase(std::remove_if(m_pendingNacks.begin(), m_pendingNacks.end(), [&name] (const auto& item) {
+                         return item.canBePrefix ? item.name.isPrefixOf(name) : item.name == name;
+                       }),
+                       m_pendingNacks.end());
+  if (!isLoaded) {
+    return;
+  }
+  if (auto usage = findZoneUsage(data.getName())) {
+    usage->nRecords++;
+    usage->nBytes += data.wireEncode().size();
+  }
+  if (expiry) {
+    m_expiryWheel.insert(data.getName(), *expiry);
+  }
+}
+
+void
+CtModule::removeData(const Name& name)
+{
+  auto data = m_storage->findData(name);
+  m_storage->deleteData(name);
+  forgetData(name, data.get());
+}
+
+void
+CtModule::forgetData(const Name& name, const Data* data)
+{
+  // the range that starts at the record still holds, but would overlap the range re-signed
+  // before it once the record is gone
+  if (m_ranges != nullptr) {
+    m_ranges->erase(name);
+  }
+  for (auto& filter : m_zoneFilters) {
+    if (filter.first.isPrefixOf(name)) {
+      eraseNamePrefixes(filter.second, filter.first, name);
+    }
+  }
+  if (data != nullptr && isRecordLoaded(name)) {
+    m_index.erase(*data);
+    if (auto usage = findZoneUsage(name)) {
+      usage->nRecords--;
+      usage->nBytes -= data->wireEncode().size();
+    }
+  }
+}
+
+void
+CtModule::initZoneFilters()
+{
+  m_zoneFilters.clear();
+  if (m_config.negativeFilterCapacity == 0) {
+    return;
+  }
+  for (const auto& zone : m_config.recordZones) {
+    auto& filter = m_zoneFilters.emplace(zone, CountingBloomFilter(m_config.negativeFilterCapacity)).first->second;
+    m_storage->visitNames(zone, [&filter, &zone] (const Name& name) {
+      insertNamePrefixes(filter, zone, name);
+    });
+  }
+}
+
+bool
+CtModule::isDefiniteMiss(const Name& name) const
+{
+  // every filter holds all the stored names under its zone, any covering zone can answer
+  for (const auto& filter : m_zoneFilters) {
+    if (filter.first.isPrefixOf(name)) {
+      return !filter.second.mayContain(CtStorage::computeNameDigest(name));
+    }
+  }
+  return false;
+}
+
+optional<time::system_clock::time_point>
+CtModule::getExpiry(const Data& data)
+{
+  const Name& name = data.getName();
+  try {
+    if (Certificate::isValidName(name)) {
+      return Certificate(data).getValidityPeriod().getPeriod().second;
+    }
+    if (record::Record::isValidName(name)) {
+      // /<prefix>/REVOKE/<keyid>/<issuer>/<version>/<revoker> revokes /<prefix>/KEY/<keyid>/<issuer>/<version>
+      Name certName = name.getPrefix(record::Record::KEYWORD_OFFSET)
+                          .append("KEY")
+                          .append(name.getSubName(record::Record::KEYID_OFFSET, 3));
+      auto cert = m_storage->findData(certName);
+      if (cert != nullptr) {
+        return Certificate(*cert).getValidityPeriod().getPeriod().second;
+      }
+      // the revoked certificate may still be valid, the revocation must outlive it
+      return nullopt;
+    }
+  }
+  catch (const ndn::tlv::Error& e) {
+    NDN_LOG_DEBUG("Cannot read the validity of " << name << ": " << e.what());
+  }
+  if (m_config.recordRetention > time::seconds::zero()) {
+    return time::system_clock::now() + m_config.recordRetention;
+  }
+  return nullopt;
+}
+
+void
+CtModule::initRecords()
+{
+  m_zoneUsage.clear();
+  m_recordLoaders.clear();
+  for (const auto& zone : m_config.recordZones) {
+    m_zoneUsage.emplace(zone, ZoneUsage());
+    // an empty zone is loaded already, and is usable right away
+    if (!m_storage->listNames(zone, nullopt, 1).empty()) {
+      m_recordLoaders.emplace(zone, CtCursor(*m_storage, zone));
+    }
+  }
+  if (isLoadingRecords()) {
+    m_loadEvent = m_scheduler.schedule(0_ms, [this] { loadRecords(); });
+  }
+  m_sweepEvent = m_scheduler.schedule(EXPIRY_TICK, [this] { sweepExpiredRecords(); });
+}
+
+void
+CtModule::loadRecords()
+{
+  size_t nLoaded = 0;
+  while (isLoadingRecords() && nLoaded < LOAD_BUDGET) {
+    auto loader = m_recordLoaders.begin();
+    const Name& zone = loader->first;
+    for (const auto& data : loader->second.next(LOAD_BUDGET - nLoaded)) {
+      nLoaded++;
+      // nested zones are scanned too, a record is loaded with the zone it belongs to
+      const Name& name = data->getName();
+      if (findZone(name) != &zone) {
+        continue;
+      }
+      m_index.insert(*data);
+      if (auto usage = findZoneUsage(name)) {
+        usage->nRecords++;
+        usage->nBytes += data->wireEncode().size();
+      }
+      auto expiry = getExpiry(*data);
+      if (expiry) {
+        m_expiryWheel.insert(name, *expiry);
+      }
+    }
+    if (loader->second.isDone()) {
+      NDN_LOG_DEBUG("Loaded the records of zone " << zone << ": " << m_zoneUsage[zone].nRecords);
+      m_recordLoaders.erase(loader);
+    }
+  }
+  if (isLoadingRecords()) {
+    // the next records are loaded right after the pending queries are served
+    m_loadEvent = m_scheduler.schedule(0_ms, [this] { loadRecords(); });
+    return;
+  }
+  std::vector<Name> submissions;
+  for (const auto& queue : m_pendingUpdates) {
+    submissions.push_back(queue.first);
+  }
+  for (const auto& submission : submissions) {
+    applyUpdates(submission);
+  }
+}
+
+bool
+CtModule::isRecordLoaded(const Name& name) const
+{
+  auto zone = findZone(name);
+  if (zone == nullptr) {
+    return true;
+  }
+  auto loader = m_recordLoaders.find(*zone);
+  if (loader == m_recordLoaders.end()) {
+    return true;
+  }
+  // the scan goes in canonical order, it has passed the names up to its position
+  const auto& position = loader->second.getPosition();
+  return position && name <= *position;
+}
+
+void
+CtModule::sweepExpiredRecords()
+{
+  size_t nExpired = 0;
+  bool isCaughtUp = m_expiryWheel.advance(time::system_clock::now(), SWEEP_BUDGET, [&] (const Name& name) {
+    try {
+      removeData(name);
+      nExpired++;
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_DEBUG("Expired record " << name << " cannot be removed: " << e.what());
+    }
+  });
+  if (nExpired > 0) {
+    NDN_LOG_TRACE("Removed " << nExpired << " expired records");
+    // records of submissions not committed yet are left to the commit of their submissions,
+    // which also covers these removals
+    if (m_uncommittedRecords.empty()) {
+      try {
+        m_storage->commit();
+      }
+      catch (const std::exception& e) {
+        NDN_LOG_ERROR("CT storage cannot commit expired records: " << e.what());
+      }
+    }
+  }
+  // an unfinished sweep continues right after the pending queries are served
+  m_sweepEvent = m_scheduler.schedule(isCaughtUp ? EXPIRY_TICK : 0_ms, [this] { sweepExpiredRecords(); });
+}
+
+const Name*
+CtModule::findZone(const Name& name) const
+{
+  // a record belongs to the first configured zone covering it
+  for (const auto& zone : m_config.recordZones) {
+    if (zone.isPrefixOf(name)) {
+      return &zone;
+    }
+  }
+  return nullptr;
+}
+
+CtModule::ZoneUsage*
+CtModule::findZoneUsage(const Name& name)
+{
+  auto zone = findZone(name);
+  return zone == nullptr ? nullptr : &m_zoneUsage[*zone];
+}
+
+bool
+CtModule::isOverQuota(const Data& data) const
+{
+  auto zone = findZone(data.getName());
+  if (zone == nullptr) {
+    return false;
+  }
+  // a missing entry means no quota, or no usage yet
+  auto quota = m_config.zoneQuotas.find(*zone);
+  if (quota == m_config.zoneQuotas.end() || quota->second == 0) {
+    return false;
   }
+  auto usage = m_zoneUsage.find(*zone);
+  uint64_t nBytes = usage == m_zoneUsage.end() ? 0 : usage->second.nBytes;
+  return nBytes + data.wireEncode().size() > quota->second;
 }
 
 void
@@ -2,14 +2,26 @@
 #define NDNREVOKE_CT_MODULE_HPP
 
 #include "storage/ct-storage.hpp"
+#include "storage/ct-cursor.hpp"
+#include "storage/counting-bloom-filter.hpp"
+#include "storage/ct-index.hpp"
+#include "storage/expiry-wheel.hpp"
 #include "append/handle.hpp"
 #include "append/ct.hpp"
 #include "ct-configuration.hpp"
 #include "nack.hpp"
+#include "nack-cache.hpp"
+#include "nack-range.hpp"
+#include "name-lru-map.hpp"
+#include "signing-key-cache.hpp"
+#include "validator-pool.hpp"
 
 #include <ndn-cxx/face.hpp>
 #include <ndn-cxx/security/key-chain.hpp>
 #include <ndn-cxx/security/validator-config.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <deque>
 
 namespace ndnrevoke::ct {
 using appendtlv::AppendStatus;
@@ -18,7 +30,7 @@ class CtModule : boost::noncopyable
 {
 public:
   CtModule(ndn::Face& face, ndn::KeyChain& keyChain, const std::string& configPath,
-           const std::string& storageType = "ct-storage-memory");
+           const std::string& storageType = "");
 
   const std::unique_ptr<CtStorage>&
   getCtStorage()
@@ -32,13 +44,70 @@ public:
     return m_config;
   }
 
+  /**
+   * @brief Size of the records stored under a record zone.
+   */
+  struct ZoneUsage
+  {
+    uint64_t nRecords = 0;
+    // bytes of wire encoding
+    uint64_t nBytes = 0;
+  };
+
+  const std::map<Name, ZoneUsage>&
+  getZoneUsage() const
+  {
+    return m_zoneUsage;
+  }
+
   void
   onQuery(const Interest& query);
 
+  /**
+   * @brief Answer /<ct-prefix>/LEDGER/INDEX/<kind>/<value>[/<after>] with the names of the
+   *        matching records.
+   *
+   * <kind> is one of the CtIndex kinds, e.g., PUBKEY-HASH to get the revocation status of
+   * a key from the SHA-256 digest of its public key.  A reply holds up to MAX_INDEX_RESULTS
+   * names; if more records match, it ends with an IndexNextPage element carrying the query
+   * of the next page, whose <after> component is the wire of the last name of the reply.
+   */
+  void
+  onIndexQuery(const Interest& query);
+
 
 NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
 
-  AppendStatus onDataSubmission(const Data& data);
+  /**
+   * @brief Validate and store a submitted Data, then report its status to @p done.
+   *
+   * Submitted Data are validated concurrently, on the validator workers if any, but the Data
+   * of one submission are stored and reported in the order they were submitted.  A slow
+   * validation only holds back the Data after it in the same submission.
+   */
+  void
+  onDataSubmission(const Name& submission, const Data& data, const append::UpdateDoneCallback& done);
+
+  /**
+   * @brief Store the validated Data at the front of the queue of @p submission.
+   */
+  void
+  applyUpdates(const Name& submission);
+
+  /**
+   * @param data the validated Data, or nullopt if the validation failed
+   */
+  AppendStatus
+  storeSubmission(const optional<Data>& data);
+
+  /**
+   * @brief Make the records stored from a submission durable before it is acked.
+   *
+   * If the commit fails, the records stored from submissions since the last commit are
+   * rolled back, so that they are not served while the submitters are told they failed.
+   */
+  bool
+  onSubmissionCommit();
 
   void
   registerPrefix();
@@ -49,13 +118,225 @@ NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   bool
   isValidQuery(Name queryName);
 
+  /**
+   * @brief Reply a signed nack to @p query, reusing a cached one when possible.
+   */
+  void
+  replyNack(const Interest& query);
+
+  std::shared_ptr<const Data>
+  makeNack(const Name& name);
+
+  /**
+   * @brief Produce a nack for @p name, right away or in the next batch.
+   * @param isRefresh whether the nack replaces a cached one rather than answers a query
+   */
+  void
+  requestNack(const Name& name, bool canBePrefix, bool isRefresh);
+
+  /**
+   * @param root the batch root of @p nack, if it is batched
+   */
+  void
+  deliverNack(const Name& name, bool canBePrefix, bool isRefresh, std::shared_ptr<const Data> nack,
+              std::shared_ptr<const Data> root = nullptr);
+
+  /**
+   * @brief Sign the Merkle root of the pending nacks and deliver them with their proofs.
+   */
+  void
+  flushNackBatch();
+
+  /**
+   * @return the batch root of @p version, or nullptr if it is no longer served
+   */
+  std::shared_ptr<const Data>
+  findBatchRoot(uint64_t version);
+
+  void
+  onBatchRootQuery(const Interest& query);
+
+  /**
+   * @brief Signed statement of a range between stored names, reused until it nears expiry
+   *        or a record is stored in the range.
+   */
+  struct RangeEntry
+  {
+    nack::RangeStatement statement;
+    std::shared_ptr<const Data> data;
+    time::steady_clock::time_point signedAt;
+  };
+
+  /**
+   * @brief Reply a nack to @p query that embeds the statement of the range around its name.
+   * @return whether the query is handled, false if it is in no record zone
+   */
+  bool
+  replyRangeNack(const Interest& query);
+
+  /**
+   * @return the statement of the range of @p zone covering @p name, cached or signed now
+   */
+  RangeEntry
+  findRangeStatement(const Name& zone, const Name& name, bool canBePrefix);
+
+  /**
+   * @brief Store @p data and record it in the negative lookup filters, the indexes and the zone usage.
+   */
+  void
+  storeData(const Data& data);
+
+  /**
+   * @brief Prime one negative lookup filter per record zone from the storage.
+   */
+  void
+  initZoneFilters();
+
+  /**
+   * @return whether @p name is definitely not stored, according to the filter of its zone
+   */
+  bool
+  isDefiniteMiss(const Name& name) const;
+
+  /**
+   * @return the record zone of @p name, or nullptr if it is in no zone
+   */
+  const Name*
+  findZone(const Name& name) const;
+
+  /**
+   * @return the usage of the record zone of @p name, or nullptr if it is in no zone
+   */
+  ZoneUsage*
+  findZoneUsage(const Name& name);
+
+  /**
+   * @return whether storing @p data would take its record zone over its quota
+   */
+  bool
+  isOverQuota(const Data& data) const;
+
+  /**
+   * @brief Remove @p name from the storage, the negative lookup filters, the indexes and the zone usage.
+   */
+  void
+  removeData(const Name& name);
+
+  /**
+   * @brief Remove @p name, whose record was @p data if known, from the negative lookup
+   *        filters, the indexes and the zone usage, but not from the storage.
+   */
+  void
+  forgetData(const Name& name, const Data* data);
+
+  /**
+   * @return when @p data stops mattering: a certificate expires with its validity period,
+   *         a revocation record with the validity of the revoked certificate when it is
+   *         stored and never otherwise, and any other record after the configured retention
+   */
+  optional<time::system_clock::time_point>
+  getExpiry(const Data& data);
+
+  /**
+   * @brief Start loading the records found in the storage into the indexes, the zone usage
+   *        and the expiry wheel.
+   *
+   * Loading goes on in the background, LOAD_BUDGET records per event, so that a large storage
+   * does not delay the start.  Until it is done, submissions wait and index queries are not
+   * answered, as both would rely on the records not loaded yet.
+   */
+  void
+  initRecords();
+
+  /**
+   * @brief Load up to LOAD_BUDGET records, then continue in another event or apply the
+   *        submissions that waited for loading.
+   */
+  void
+  loadRecords();
+
+  /**
+   * @return whether the record @p name, if stored, is loaded already, so that storing or
+   *         removing it is accounted now and not when its zone is loaded
+   */
+  bool
+  isRecordLoaded(const Name& name) const;
+
+  bool
+  isLoadingRecords() const
+  {
+    return !m_recordLoaders.empty();
+  }
+
+  /**
+   * @brief Remove the expired records, up to SWEEP_BUDGET of them per call.
+   */
+  void
+  sweepExpiredRecords();
+
+public:
+  static const time::milliseconds EXPIRY_TICK;
+  static const size_t EXPIRY_SLOTS;
+  static const size_t SWEEP_BUDGET;
+  static const size_t LOAD_BUDGET;
+  // names per index reply, so that the reply fits in a packet
+  static const size_t MAX_INDEX_RESULTS;
+  // signed batch roots kept to be fetched by checkers
+  static const size_t MAX_BATCH_ROOTS;
+
 NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   ndn::Face& m_face;
   CtConfig m_config;
   ndn::KeyChain& m_keyChain;
+  SigningKeyCache m_signingKeys{m_keyChain};
+  Signer m_nackSigner;
+  // batch roots and range statements, checked by the trust schema unlike plain nacks
+  Signer m_statementSigner;
+  Signer m_indexSigner;
   ndn::ValidatorConfig m_validator{m_face};
+  std::unique_ptr<ValidatorPool> m_validatorPool;
+
+  struct PendingUpdate
+  {
+    append::UpdateDoneCallback done;
+    bool isValidated = false;
+    optional<Data> data;
+  };
+  // submitted Data in submission order, waiting for their validation or that of earlier ones,
+  // keyed by submission
+  std::map<Name, std::deque<std::shared_ptr<PendingUpdate>>> m_pendingUpdates;
+  // records stored from submissions since the last commit, oldest first
+  std::vector<Data> m_uncommittedRecords;
   std::unique_ptr<append::Ct> m_appendCt;
   std::unique_ptr<CtStorage> m_storage;
+  // negative lookup filters, keyed by record zone
+  std::map<Name, CountingBloomFilter> m_zoneFilters;
+  CtIndex m_index;
+  std::map<Name, ZoneUsage> m_zoneUsage;
+  std::unique_ptr<NackCache> m_nackCache;
+
+  struct PendingNack
+  {
+    Name name;
+    bool canBePrefix;
+    bool isRefresh;
+  };
+  std::vector<PendingNack> m_pendingNacks;
+  // signed batch roots by version
+  std::map<uint64_t, std::shared_ptr<const Data>> m_batchRoots;
+  // roots evicted from m_batchRoots while cached nacks still hold them
+  std::map<uint64_t, std::weak_ptr<const Data>> m_pinnedBatchRoots;
+  uint64_t m_lastBatchVersion = 0;
+  // range statements by lower bound, or by zone for the first range of a zone
+  std::unique_ptr<NameLruMap<RangeEntry>> m_ranges;
+  uint64_t m_lastRangeVersion = 0;
+  ndn::Scheduler m_scheduler{m_face.getIoService()};
+  ExpiryWheel m_expiryWheel{EXPIRY_TICK, EXPIRY_SLOTS};
+  ndn::scheduler::ScopedEventId m_sweepEvent;
+  // scans of the record zones not loaded yet, keyed by record zone
+  std::map<Name, CtCursor> m_recordLoaders;
+  ndn::scheduler::ScopedEventId m_loadEvent;
+  ndn::scheduler::ScopedEventId m_nackBatchEvent;
 
   append::Handle m_handle;
 };
@@ -0,0 +1,106 @@
+#include "nack-batch.hpp"
+
+namespace ndnrevoke::nack {
+
+// domain separation of leaves and inner nodes
+static const uint8_t LEAF_PREFIX = 0x00;
+static const uint8_t NODE_PREFIX = 0x01;
+
+static Buffer
+hashNode(const Buffer& left, const Buffer& right)
+{
+  Sha256 sha;
+  sha.update({&NODE_PREFIX, 1});
+  sha.update(left);
+  sha.update(right);
+  return *sha.computeDigest();
+}
+
+Block
+encodeBatchProof(const BatchProof& proof)
+{
+  Block content(ndn::tlv::Content);
+  content.push_back(ndn::encoding::makeNestedBlock(tlv::NackBatchRoot, proof.rootName));
+  content.push_back(ndn::encoding::makeNonNegativeIntegerBlock(tlv::NackBatchLeafIndex, proof.leafIndex));
+  Buffer path;
+  for (const auto& digest : proof.path) {
+    path.insert(path.end(), digest.begin(), digest.end());
+  }
+  content.push_back(ndn::encoding::makeBinaryBlock(tlv::NackBatchPath, path));
+  content.encode();
+  return content;
+}
+
+optional<BatchProof>
+decodeBatchProof(const Data& nack)
+{
+  Block content = nack.getContent();
+  content.parse();
+  auto root = content.find(tlv::NackBatchRoot);
+  auto leafIndex = content.find(tlv::NackBatchLeafIndex);
+  auto path = content.find(tlv::NackBatchPath);
+  if (root == content.elements_end() || leafIndex == content.elements_end() ||
+      path == content.elements_end()) {
+    return nullopt;
+  }
+  if (path->value_size() % ndn::util::Sha256::DIGEST_SIZE != 0) {
+    NDN_THROW(ndn::tlv::Error("NackBatchPath is not a sequence of SHA-256 digests"));
+  }
+
+  BatchProof proof;
+  proof.rootName = Name(root->blockFromValue());
+  proof.leafIndex = ndn::encoding::readNonNegativeInteger(*leafIndex);
+  for (auto it = path->value_begin(); it != path->value_end(); it += ndn::util::Sha256::DIGEST_SIZE) {
+    proof.path.emplace_back(it, it + ndn::util::Sha256::DIGEST_SIZE);
+  }
+  return proof;
+}
+
+Buffer
+computeLeafDigest(const Name& nackName)
+{
+  Sha256 sha;
+  const Block& wire = nackName.wireEncode();
+  sha.update({&LEAF_PREFIX, 1});
+  sha.update(make_span(&*wire.begin(), wire.size()));
+  return *sha.computeDigest();
+}
+
+Buffer
+buildMerkleTree(const std::vector<Buffer>& leaves, std::vector<std::vector<Buffer>>& paths)
+{
+  if (leaves.empty()) {
+    NDN_THROW(std::invalid_argument("A Merkle tree needs at least one leaf"));
+  }
+  paths.assign(leaves.size(), {});
+  // each node of the current level covers width leaves
+  std::vector<Buffer> level = leaves;
+  size_t width = 1;
+  while (level.size() > 1) {
+    std::vector<Buffer> parents;
+    for (size_t i = 0; i < level.size(); i += 2) {
+      const Buffer& left = level[i];
+      const Buffer& right = i + 1 < level.size() ? level[i + 1] : level[i];
+      for (size_t leaf = i * width; leaf < std::min((i + 2) * width, leaves.size()); leaf++) {
+        paths[leaf].push_back(leaf < (i + 1) * width ? right : left);
+      }
+      parents.push_back(hashNode(left, right));
+    }
+    level = std::move(parents);
+    width *= 2;
+  }
+  return level.front();
+}
+
+Buffer
+computeMerkleRoot(const Buffer& leaf, uint64_t leafIndex, const std::vector<Buffer>& path)
+{
+  Buffer node = leaf;
+  for (const auto& sibling : path) {
+    node = (leafIndex & 1) == 0 ? hashNode(node, sibling) : hashNode(sibling, node);
+    leafIndex >>= 1;
+  }
+  return node;
+}
+
+} // namespace ndnrevoke::nack
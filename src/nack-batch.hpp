@@ -0,0 +1,56 @@
+#ifndef NDNREVOKE_NACK_BATCH_HPP
+#define NDNREVOKE_NACK_BATCH_HPP
+
+#include "revocation-common.hpp"
+
+namespace ndnrevoke::nack {
+
+/**
+ * @brief Proof that a nack belongs to a batch whose Merkle root is signed once.
+ *
+ * A batched nack is signed with DigestSha256 only and carries this proof in its content:
+ * the name of the Data holding the signed root (/<ct-prefix>/LEDGER/NACK-BATCH/<version>),
+ * the position of the nack among the leaves, and the sibling digests from the leaf up.
+ * The leaf of a nack is the digest of its name, which states the query and the time.
+ *
+ *   Content = NackBatchRoot NackBatchLeafIndex NackBatchPath
+ *   NackBatchRoot = NACK-BATCH-ROOT-TYPE TLV-LENGTH Name
+ *   NackBatchLeafIndex = NACK-BATCH-LEAF-INDEX-TYPE TLV-LENGTH NonNegativeInteger
+ *   NackBatchPath = NACK-BATCH-PATH-TYPE TLV-LENGTH *(32 OCTET)
+ */
+struct BatchProof
+{
+  Name rootName;
+  uint64_t leafIndex = 0;
+  std::vector<Buffer> path;
+};
+
+Block
+encodeBatchProof(const BatchProof& proof);
+
+/**
+ * @return the proof in the content of @p nack, or nullopt if it is not a batched nack
+ */
+optional<BatchProof>
+decodeBatchProof(const Data& nack);
+
+Buffer
+computeLeafDigest(const Name& nackName);
+
+/**
+ * @brief Build the Merkle tree over @p leaves, an odd node being paired with itself.
+ * @param[out] paths the sibling digests of each leaf, from the leaf up
+ * @return the root digest
+ */
+Buffer
+buildMerkleTree(const std::vector<Buffer>& leaves, std::vector<std::vector<Buffer>>& paths);
+
+/**
+ * @return the root digest that @p leaf at @p leafIndex leads to through @p path
+ */
+Buffer
+computeMerkleRoot(const Buffer& leaf, uint64_t leafIndex, const std::vector<Buffer>& path);
+
+} // namespace ndnrevoke::nack
+
+#endif // NDNREVOKE_NACK_BATCH_HPP
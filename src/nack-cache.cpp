@@ -0,0 +1,115 @@
+#include "nack-cache.hpp"
+
+namespace ndnrevoke::ct {
+
+const double NackCache::REUSE_RATIO = 0.9;
+const double NackCache::REFRESH_RATIO = 0.5;
+
+NackCache::NackCache(size_t capacity, time::milliseconds lifetime)
+  : m_capacity(capacity)
+  , m_lifetime(lifetime)
+{
+}
+
+const NackCache::Entry*
+NackCache::find(const Name& name, bool canBePrefix)
+{
+  auto& index = getIndex(canBePrefix);
+  auto it = index.find(name);
+  if (it == index.end()) {
+    return nullptr;
+  }
+  auto age = time::steady_clock::now() - it->second->entry.signedAt;
+  if (age >= m_lifetime * REUSE_RATIO) {
+    erase(index, name);
+    return nullptr;
+  }
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return &it->second->entry;
+}
+
+std::shared_ptr<const Data>
+NackCache::makeReply(const Name& name, bool canBePrefix, const std::function<void(Data&)>& sign)
+{
+  auto& index = getIndex(canBePrefix);
+  auto it = index.find(name);
+  if (it == index.end()) {
+    return nullptr;
+  }
+  auto& entry = it->second->entry;
+  auto now = time::steady_clock::now();
+  if (entry.reply == nullptr || now >= entry.replyUntil) {
+    auto step = time::duration_cast<time::milliseconds>(m_lifetime * (1 - REUSE_RATIO));
+    auto remaining = time::duration_cast<time::milliseconds>(entry.signedAt + m_lifetime - now);
+    auto reply = std::make_shared<Data>(*entry.nack);
+    reply->setFreshnessPeriod(std::max(remaining - step, 0_ms));
+    sign(*reply);
+    entry.reply = std::move(reply);
+    entry.replyUntil = now + step;
+  }
+  return entry.reply;
+}
+
+bool
+NackCache::needsRefresh(const Entry& entry) const
+{
+  return !entry.isRefreshing && time::steady_clock::now() - entry.signedAt >= m_lifetime * REFRESH_RATIO;
+}
+
+void
+NackCache::markRefreshing(const Name& name, bool canBePrefix)
+{
+  auto& index = getIndex(canBePrefix);
+  auto it = index.find(name);
+  if (it != index.end()) {
+    it->second->entry.isRefreshing = true;
+  }
+}
+
+void
+NackCache::insert(const Name& name, bool canBePrefix, std::shared_ptr<const Data> nack,
+                  std::shared_ptr<const Data> root)
+{
+  if (m_capacity == 0) {
+    return;
+  }
+  auto& index = getIndex(canBePrefix);
+  erase(index, name);
+  m_entries.push_front({name, canBePrefix, {std::move(nack), std::move(root), time::steady_clock::now()}});
+  index.emplace(name, m_entries.begin());
+  while (m_entries.size() > m_capacity) {
+    erase(getIndex(m_entries.back().canBePrefix), m_entries.back().name);
+  }
+}
+
+void
+NackCache::refresh(const Name& name, bool canBePrefix, std::shared_ptr<const Data> nack,
+                   std::shared_ptr<const Data> root)
+{
+  auto& index = getIndex(canBePrefix);
+  auto it = index.find(name);
+  if (it != index.end()) {
+    it->second->entry = {std::move(nack), std::move(root), time::steady_clock::now()};
+  }
+}
+
+void
+NackCache::invalidate(const Name& name)
+{
+  erase(m_exactIndex, name);
+  for (size_t i = 0; i <= name.size(); i++) {
+    erase(m_prefixIndex, name.getPrefix(i));
+  }
+}
+
+void
+NackCache::erase(Index& index, const Name& name)
+{
+  auto it = index.find(name);
+  if (it != index.end()) {
+    m_entries.erase(it->second);
+    index.erase(it);
+  }
+}
+
+} // namespace ndnrevoke::ct
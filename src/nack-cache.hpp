@@ -0,0 +1,124 @@
+#ifndef NDNREVOKE_NACK_CACHE_HPP
+#define NDNREVOKE_NACK_CACHE_HPP
+
+#include "revocation-common.hpp"
+
+#include <list>
+#include <unordered_map>
+
+namespace ndnrevoke::ct {
+
+/**
+ * @brief Bounded LRU cache of the signed nacks replied to CT queries.
+ *
+ * A nack is keyed by the query name and whether the query can be a prefix, since a nack
+ * to an exact query says nothing about the names under it.  A cached nack is reused for
+ * REUSE_RATIO of its lifetime; past REFRESH_RATIO it is still reused, but the caller is
+ * told to sign a replacement, so that the nacks of hot names never expire.
+ */
+class NackCache
+{
+public:
+  static const double REUSE_RATIO;
+  static const double REFRESH_RATIO;
+
+  struct Entry
+  {
+    std::shared_ptr<const Data> nack;
+    // the batch root the nack is proven by, kept for as long as the nack is cached
+    std::shared_ptr<const Data> root;
+    time::steady_clock::time_point signedAt;
+    bool isRefreshing = false;
+    // the copy of the nack replied on reuse, and until when it can be replied
+    std::shared_ptr<const Data> reply;
+    time::steady_clock::time_point replyUntil;
+  };
+
+  /**
+   * @param lifetime the freshness period of the nacks
+   */
+  NackCache(size_t capacity, time::milliseconds lifetime);
+
+  /**
+   * @return the nack cached for the query, or nullptr if there is none that can be reused
+   */
+  const Entry*
+  find(const Name& name, bool canBePrefix);
+
+  /**
+   * @brief Get the nack to reply to the query with, or nullptr if none is cached.
+   *
+   * The cached nack keeps the freshness period it was signed with, so replying it again
+   * would let downstream caches hold it past its lifetime.  The reply is instead a copy
+   * whose freshness period ends one step before the lifetime does, signed by @p sign and
+   * replied for that step, where a step is the part of the lifetime the nack is not reused.
+   */
+  std::shared_ptr<const Data>
+  makeReply(const Name& name, bool canBePrefix, const std::function<void(Data&)>& sign);
+
+  /**
+   * @return whether the nack of @p entry should be replaced by a new one
+   */
+  bool
+  needsRefresh(const Entry& entry) const;
+
+  /**
+   * @brief Mark the nack of the query as being refreshed, so that it is refreshed once.
+   */
+  void
+  markRefreshing(const Name& name, bool canBePrefix);
+
+  void
+  insert(const Name& name, bool canBePrefix, std::shared_ptr<const Data> nack,
+         std::shared_ptr<const Data> root = nullptr);
+
+  /**
+   * @brief Replace the nack of the query if it is still cached.
+   */
+  void
+  refresh(const Name& name, bool canBePrefix, std::shared_ptr<const Data> nack,
+          std::shared_ptr<const Data> root = nullptr);
+
+  /**
+   * @brief Drop the nacks that a record named @p name contradicts: the nack of an exact
+   *        query for @p name, and of a prefix query for @p name or any of its prefixes.
+   */
+  void
+  invalidate(const Name& name);
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+private:
+  struct Item
+  {
+    Name name;
+    bool canBePrefix;
+    Entry entry;
+  };
+  using Index = std::unordered_map<Name, std::list<Item>::iterator>;
+
+  Index&
+  getIndex(bool canBePrefix)
+  {
+    return canBePrefix ? m_prefixIndex : m_exactIndex;
+  }
+
+  void
+  erase(Index& index, const Name& name);
+
+private:
+  size_t m_capacity;
+  time::milliseconds m_lifetime;
+  // most recently used first
+  std::list<Item> m_entries;
+  Index m_exactIndex;
+  Index m_prefixIndex;
+};
+
+} // namespace ndnrevoke::ct
+
+#endif // NDNREVOKE_NACK_CACHE_HPP
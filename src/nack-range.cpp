@@ -0,0 +1,82 @@
+#include "nack-range.hpp"
+
+namespace ndnrevoke::nack {
+
+bool
+RangeStatement::covers(const Name& name, bool canBePrefix) const
+{
+  if (!zone.isPrefixOf(name)) {
+    return false;
+  }
+  if (lower && !(*lower < name)) {
+    return false;
+  }
+  if (upper) {
+    // the names starting with name follow it, up to the first name that does not
+    if (!(name < *upper) || (canBePrefix && name.isPrefixOf(*upper))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Block
+encodeRangeStatement(const RangeStatement& statement)
+{
+  Block content(ndn::tlv::Content);
+  content.push_back(statement.zone.wireEncode());
+  if (statement.lower) {
+    content.push_back(ndn::encoding::makeNestedBlock(tlv::NackRangeLower, *statement.lower));
+  }
+  if (statement.upper) {
+    content.push_back(ndn::encoding::makeNestedBlock(tlv::NackRangeUpper, *statement.upper));
+  }
+  content.encode();
+  return content;
+}
+
+RangeStatement
+decodeRangeStatement(const Data& data)
+{
+  Block content = data.getContent();
+  content.parse();
+  auto zone = content.find(ndn::tlv::Name);
+  if (zone == content.elements_end()) {
+    NDN_THROW(ndn::tlv::Error("Range statement has no record zone"));
+  }
+
+  RangeStatement statement;
+  statement.zone = Name(*zone);
+  auto lower = content.find(tlv::NackRangeLower);
+  if (lower != content.elements_end()) {
+    statement.lower = Name(lower->blockFromValue());
+  }
+  auto upper = content.find(tlv::NackRangeUpper);
+  if (upper != content.elements_end()) {
+    statement.upper = Name(upper->blockFromValue());
+  }
+  return statement;
+}
+
+Block
+encodeRangeNack(const Data& statement)
+{
+  Block content(ndn::tlv::Content);
+  content.push_back(ndn::encoding::makeNestedBlock(tlv::NackRange, statement));
+  content.encode();
+  return content;
+}
+
+optional<Data>
+decodeRangeNack(const Data& nack)
+{
+  Block content = nack.getContent();
+  content.parse();
+  auto statement = content.find(tlv::NackRange);
+  if (statement == content.elements_end()) {
+    return nullopt;
+  }
+  return Data(statement->blockFromValue());
+}
+
+} // namespace ndnrevoke::nack
@@ -0,0 +1,61 @@
+#ifndef NDNREVOKE_NACK_RANGE_HPP
+#define NDNREVOKE_NACK_RANGE_HPP
+
+#include "revocation-common.hpp"
+
+namespace ndnrevoke::nack {
+
+/**
+ * @brief Statement that no record is stored strictly between two adjacent names of a record zone.
+ *
+ * A range statement is the content of a Data /<ct-prefix>/LEDGER/RANGE/<version> signed by
+ * the CT.  It is signed once per interval between stored names and reused for every query
+ * falling in that interval: such a query is answered with a nack signed with DigestSha256
+ * only, which embeds the signed statement.
+ *
+ *   Content = Name [NackRangeLower] [NackRangeUpper]
+ *   NackRangeLower = NACK-RANGE-LOWER-TYPE TLV-LENGTH Name
+ *   NackRangeUpper = NACK-RANGE-UPPER-TYPE TLV-LENGTH Name
+ *
+ * The Name is the record zone, and a missing bound extends the range to that end of the zone.
+ * The content of a nack is NackRange = NACK-RANGE-TYPE TLV-LENGTH Data.
+ */
+struct RangeStatement
+{
+  Name zone;
+  // excluded bounds, nullopt for the ends of the zone
+  optional<Name> lower;
+  optional<Name> upper;
+
+  /**
+   * @return whether the range proves that no record is named @p name, or, if @p canBePrefix,
+   *         that no record name starts with @p name
+   */
+  bool
+  covers(const Name& name, bool canBePrefix) const;
+};
+
+Block
+encodeRangeStatement(const RangeStatement& statement);
+
+/**
+ * @throw ndn::tlv::Error the content of @p data is not a range statement
+ */
+RangeStatement
+decodeRangeStatement(const Data& data);
+
+/**
+ * @return the content of a nack embedding the signed @p statement
+ */
+Block
+encodeRangeNack(const Data& statement);
+
+/**
+ * @return the signed statement embedded in @p nack, or nullopt if it is not a range nack
+ */
+optional<Data>
+decodeRangeNack(const Data& nack);
+
+} // namespace ndnrevoke::nack
+
+#endif // NDNREVOKE_NACK_RANGE_HPP
@@ -0,0 +1,112 @@
+#ifndef NDNREVOKE_NAME_LRU_MAP_HPP
+#define NDNREVOKE_NAME_LRU_MAP_HPP
+
+#include "revocation-common.hpp"
+
+#include <list>
+#include <map>
+
+namespace ndnrevoke {
+
+/**
+ * @brief Bounded map ordered by Name that evicts its least recently used entry when full.
+ *
+ * Lookups by name, including the lookup of the entry at or before a name, count as uses.
+ * A capacity of 0 means no bound.
+ */
+template<typename Value>
+class NameLruMap
+{
+public:
+  explicit
+  NameLruMap(size_t capacity)
+    : m_capacity(capacity)
+  {
+  }
+
+  /**
+   * @return the value of @p key, or nullptr
+   */
+  Value*
+  find(const Name& key)
+  {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+      return nullptr;
+    }
+    touch(it);
+    return &it->second.value;
+  }
+
+  /**
+   * @return the entry with the greatest key not after @p name, or {nullptr, nullptr}
+   */
+  std::pair<const Name*, Value*>
+  findFloor(const Name& name)
+  {
+    auto it = m_entries.upper_bound(name);
+    if (it == m_entries.begin()) {
+      return {nullptr, nullptr};
+    }
+    --it;
+    touch(it);
+    return {&it->first, &it->second.value};
+  }
+
+  void
+  insert(const Name& key, Value value)
+  {
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+      it->second.value = std::move(value);
+      touch(it);
+      return;
+    }
+    if (m_capacity > 0 && m_entries.size() >= m_capacity) {
+      m_entries.erase(m_order.back());
+      m_order.pop_back();
+    }
+    m_order.push_front(key);
+    m_entries.emplace(key, Entry{std::move(value), m_order.begin()});
+  }
+
+  void
+  erase(const Name& key)
+  {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+      return;
+    }
+    m_order.erase(it->second.position);
+    m_entries.erase(it);
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+private:
+  struct Entry
+  {
+    Value value;
+    typename std::list<Name>::iterator position;
+  };
+
+  void
+  touch(typename std::map<Name, Entry>::iterator it)
+  {
+    m_order.splice(m_order.begin(), m_order, it->second.position);
+  }
+
+private:
+  size_t m_capacity;
+  std::map<Name, Entry> m_entries;
+  // most recently used first
+  std::list<Name> m_order;
+};
+
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_NAME_LRU_MAP_HPP
@@ -69,7 +69,14 @@ enum : uint32_t {
   PublicKeyHash = 202,
   RevocationReason = 203,
   NackReason = 204,
-  NotBefore = 205
+  NotBefore = 205,
+  NackBatchRoot = 206,
+  NackBatchLeafIndex = 207,
+  NackBatchPath = 208,
+  NackRange = 209,
+  NackRangeLower = 210,
+  NackRangeUpper = 211,
+  IndexNextPage = 212
 };
 
 // Revocation Reason
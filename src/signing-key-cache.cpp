@@ -0,0 +1,90 @@
+#include "signing-key-cache.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndnrevoke::ct {
+
+NDN_LOG_INIT(ndnrevoke.signing);
+
+using ndn::security::SigningInfo;
+
+SigningKeyCache::SigningKeyCache(ndn::KeyChain& keyChain)
+  : m_keyChain(keyChain)
+{
+}
+
+Signer
+SigningKeyCache::resolve(const SigningInfo& signingInfo)
+{
+  ndn::security::Key key;
+  optional<Certificate> cert;
+  try {
+    auto& pib = m_keyChain.getPib();
+    const Name& name = signingInfo.getSignerName();
+    switch (signingInfo.getSignerType()) {
+      case SigningInfo::SIGNER_TYPE_NULL:
+        key = pib.getDefaultIdentity().getDefaultKey();
+        break;
+      case SigningInfo::SIGNER_TYPE_ID:
+        key = signingInfo.getPibIdentity() ? signingInfo.getPibIdentity().getDefaultKey() :
+                                             pib.getIdentity(name).getDefaultKey();
+        break;
+      case SigningInfo::SIGNER_TYPE_KEY:
+        key = signingInfo.getPibKey() ? signingInfo.getPibKey() :
+                                        pib.getIdentity(ndn::security::extractIdentityFromKeyName(name)).getKey(name);
+        break;
+      case SigningInfo::SIGNER_TYPE_CERT: {
+        Name keyName = ndn::security::extractKeyNameFromCertName(name);
+        key = pib.getIdentity(ndn::security::extractIdentityFromKeyName(keyName)).getKey(keyName);
+        cert = key.getCertificate(name);
+        break;
+      }
+      default:
+        return Signer(m_cache, signingInfo);
+    }
+    if (!cert) {
+      cert = key.getDefaultCertificate();
+    }
+  }
+  catch (const std::exception& e) {
+    NDN_THROW(std::runtime_error("Cannot resolve the signing by " + signingInfo.getSignerName().toUri() +
+                                 ": " + e.what()));
+  }
+
+  // a certificate signing keeps the certificate name as the KeyLocator
+  bool isByCert = signingInfo.getSignerType() == SigningInfo::SIGNER_TYPE_CERT;
+  auto keepParams = [&signingInfo] (SigningInfo resolved) {
+    resolved.setDigestAlgorithm(signingInfo.getDigestAlgorithm());
+    resolved.setSignatureInfo(signingInfo.getSignatureInfo());
+    return resolved;
+  };
+  try {
+    auto cachedKey = importKey(*cert);
+    NDN_LOG_DEBUG("Cached the private key of " << key.getName());
+    return Signer(m_cache, keepParams(isByCert ? ndn::signingByCertificate(cert->getName()) : SigningInfo(cachedKey)));
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_WARN("Cannot cache the private key of " << key.getName() << ": " << e.what());
+    return Signer(m_keyChain, keepParams(isByCert ? signingInfo : SigningInfo(key)));
+  }
+}
+
+ndn::security::Key
+SigningKeyCache::importKey(const Certificate& cert)
+{
+  Name identity = cert.getIdentity();
+  try {
+    return m_cache.getPib().getIdentity(identity).getKey(cert.getKeyName());
+  }
+  catch (const ndn::security::Pib::Error&) {
+    // not imported yet
+  }
+  // the password only protects the key on its way between the two TPMs
+  auto password = std::to_string(ndn::random::generateSecureWord64());
+  auto safeBag = m_keyChain.exportSafeBag(cert, password.data(), password.size());
+  m_cache.importSafeBag(*safeBag, password.data(), password.size());
+  return m_cache.getPib().getIdentity(identity).getKey(cert.getKeyName());
+}
+
+} // namespace ndnrevoke::ct
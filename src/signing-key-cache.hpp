@@ -0,0 +1,83 @@
+#ifndef NDNREVOKE_SIGNING_KEY_CACHE_HPP
+#define NDNREVOKE_SIGNING_KEY_CACHE_HPP
+
+#include "revocation-common.hpp"
+
+namespace ndnrevoke::ct {
+
+/**
+ * @brief A signing resolved to a PIB key, so that signing does no PIB lookup.
+ */
+class Signer
+{
+public:
+  Signer() = default;
+
+  Signer(ndn::KeyChain& keyChain, const ndn::security::SigningInfo& signingInfo)
+    : m_keyChain(&keyChain)
+    , m_signingInfo(signingInfo)
+  {
+  }
+
+  void
+  sign(Data& data) const
+  {
+    m_keyChain->sign(data, m_signingInfo);
+  }
+
+  ndn::KeyChain&
+  getKeyChain() const
+  {
+    return *m_keyChain;
+  }
+
+  const ndn::security::SigningInfo&
+  getSigningInfo() const
+  {
+    return m_signingInfo;
+  }
+
+private:
+  ndn::KeyChain* m_keyChain = nullptr;
+  ndn::security::SigningInfo m_signingInfo;
+};
+
+/**
+ * @brief Keeps the private keys of the CT in an in-memory KeyChain.
+ *
+ * Signing by identity through a KeyChain looks up the identity, its default key and
+ * certificate in the PIB, and a file TPM loads and parses the private key, on every call.
+ * resolve does the lookups once and copies the private key into a KeyChain of its own,
+ * backed by an in-memory PIB and TPM.  A key that cannot be exported stays in its TPM,
+ * but is still signed with without PIB lookups.
+ */
+class SigningKeyCache : boost::noncopyable
+{
+public:
+  explicit
+  SigningKeyCache(ndn::KeyChain& keyChain);
+
+  /**
+   * @brief Resolve @p signingInfo of the KeyChain to a signer with a cached key.
+   *
+   * Digest and HMAC signings need no PIB key and are signed with as they are.
+   * @throw std::runtime_error the identity, key or certificate does not exist
+   */
+  Signer
+  resolve(const ndn::security::SigningInfo& signingInfo);
+
+private:
+  /**
+   * @return the key of the cached KeyChain holding the private key of @p cert
+   */
+  ndn::security::Key
+  importKey(const Certificate& cert);
+
+private:
+  ndn::KeyChain& m_keyChain;
+  ndn::KeyChain m_cache{"pib-memory:", "tpm-memory:"};
+};
+
+} // namespace ndnrevoke::ct
+
+#endif // NDNREVOKE_SIGNING_KEY_CACHE_HPP
@@ -0,0 +1,71 @@
+#include "counting-bloom-filter.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace ndnrevoke {
+namespace ct {
+
+static const uint8_t COUNTER_MAX = std::numeric_limits<uint8_t>::max();
+
+CountingBloomFilter::CountingBloomFilter(size_t capacity, double falsePositiveRate)
+{
+  if (capacity == 0 || falsePositiveRate <= 0 || falsePositiveRate >= 1) {
+    NDN_THROW(std::invalid_argument("Invalid CountingBloomFilter parameters"));
+  }
+  // m = -n * ln(p) / ln(2)^2, k = m / n * ln(2)
+  double nSlots = std::ceil(-static_cast<double>(capacity) * std::log(falsePositiveRate) /
+                            (std::log(2) * std::log(2)));
+  m_counters.resize(static_cast<size_t>(nSlots));
+  m_nHashes = std::max<size_t>(1, static_cast<size_t>(std::round(nSlots / capacity * std::log(2))));
+}
+
+template<typename Func>
+void
+CountingBloomFilter::forEachSlot(uint64_t digest, const Func& func) const
+{
+  // double hashing over the two halves of the digest (Kirsch-Mitzenmacher)
+  uint64_t h1 = digest & 0xFFFFFFFF;
+  uint64_t h2 = (digest >> 32) | 1;
+  for (size_t i = 0; i < m_nHashes; i++) {
+    if (!func((h1 + i * h2) % m_counters.size())) {
+      return;
+    }
+  }
+}
+
+void
+CountingBloomFilter::insert(uint64_t digest)
+{
+  forEachSlot(digest, [this] (size_t slot) {
+    if (m_counters[slot] < COUNTER_MAX) {
+      m_counters[slot]++;
+    }
+    return true;
+  });
+}
+
+void
+CountingBloomFilter::erase(uint64_t digest)
+{
+  forEachSlot(digest, [this] (size_t slot) {
+    if (m_counters[slot] > 0 && m_counters[slot] < COUNTER_MAX) {
+      m_counters[slot]--;
+    }
+    return true;
+  });
+}
+
+bool
+CountingBloomFilter::mayContain(uint64_t digest) const
+{
+  bool isPresent = true;
+  forEachSlot(digest, [this, &isPresent] (size_t slot) {
+    isPresent = m_counters[slot] > 0;
+    return isPresent;
+  });
+  return isPresent;
+}
+
+} // namespace ct
+} // namespace ndnrevoke
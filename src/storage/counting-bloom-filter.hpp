@@ -0,0 +1,61 @@
+#ifndef NDNREVOKE_COUNTING_BLOOM_FILTER_HPP
+#define NDNREVOKE_COUNTING_BLOOM_FILTER_HPP
+
+#include "revocation-common.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Approximate membership filter over 64-bit name digests that supports deletion.
+ *
+ * mayContain() never returns false for an inserted digest, so a negative answer is a
+ * definite miss.  Each slot is an 8-bit counter; a saturated counter is never decremented,
+ * which keeps the filter free of false negatives at the cost of a stale positive.
+ * erase() must only be called for digests that were inserted.
+ */
+class CountingBloomFilter
+{
+public:
+  /**
+   * @param capacity expected number of elements
+   * @param falsePositiveRate target false positive rate at @p capacity elements
+   */
+  explicit
+  CountingBloomFilter(size_t capacity, double falsePositiveRate = 0.01);
+
+  void
+  insert(uint64_t digest);
+
+  void
+  erase(uint64_t digest);
+
+  bool
+  mayContain(uint64_t digest) const;
+
+  size_t
+  getNSlots() const
+  {
+    return m_counters.size();
+  }
+
+  size_t
+  getNHashes() const
+  {
+    return m_nHashes;
+  }
+
+private:
+  template<typename Func>
+  void
+  forEachSlot(uint64_t digest, const Func& func) const;
+
+private:
+  std::vector<uint8_t> m_counters;
+  size_t m_nHashes;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_COUNTING_BLOOM_FILTER_HPP
@@ -0,0 +1,167 @@
+#include "ct-cache.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+const std::string CtCache::STORAGE_TYPE = "ct-storage-cached";
+NDNREVOKE_REGISTER_CT_STORAGE_DECORATOR(CtCache);
+
+const size_t CtCache::DEFAULT_CAPACITY = 10000;
+const std::string CtCache::CAPACITY_PARAMETER = "cache-capacity";
+
+optional<std::shared_ptr<const Data>>
+CtCache::Lru::find(const Name& name)
+{
+  auto it = m_index.find(name);
+  if (it == m_index.end()) {
+    return nullopt;
+  }
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return it->second->second;
+}
+
+void
+CtCache::Lru::insert(const Name& name, std::shared_ptr<const Data> data, size_t capacity)
+{
+  if (capacity == 0) {
+    return;
+  }
+  auto it = m_index.find(name);
+  if (it != m_index.end()) {
+    it->second->second = std::move(data);
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+  m_entries.emplace_front(name, std::move(data));
+  m_index.emplace(name, m_entries.begin());
+  shrink(capacity);
+}
+
+void
+CtCache::Lru::erase(const Name& name)
+{
+  auto it = m_index.find(name);
+  if (it != m_index.end()) {
+    m_entries.erase(it->second);
+    m_index.erase(it);
+  }
+}
+
+void
+CtCache::Lru::shrink(size_t capacity)
+{
+  while (m_index.size() > capacity) {
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+}
+
+CtCache::CtCache(std::unique_ptr<CtStorage> inner, const Name& ctName, const std::string& path,
+                 const Parameters& parameters)
+  : CtStorage()
+  , m_inner(std::move(inner))
+{
+  auto capacity = parameters.find(CAPACITY_PARAMETER);
+  if (capacity != parameters.end()) {
+    try {
+      setCapacity(std::stoull(capacity->second));
+    }
+    catch (const std::logic_error&) {
+      NDN_THROW(std::runtime_error("Invalid " + CAPACITY_PARAMETER + ": " + capacity->second));
+    }
+  }
+}
+
+double
+CtCache::getHitRatio() const
+{
+  uint64_t nLookups = m_counters.nHits + m_counters.nNegativeHits + m_counters.nMisses;
+  return nLookups == 0 ? 0.0 : static_cast<double>(m_counters.nHits + m_counters.nNegativeHits) / nLookups;
+}
+
+void
+CtCache::setCapacity(size_t capacity)
+{
+  m_capacity = capacity;
+  m_exact.shrink(capacity);
+  m_latest.shrink(capacity);
+}
+
+std::shared_ptr<const Data>
+CtCache::lookup(Lru& lru, const Name& name, const std::function<std::shared_ptr<const Data>()>& fetch)
+{
+  auto cached = lru.find(name);
+  if (cached) {
+    ++(*cached == nullptr ? m_counters.nNegativeHits : m_counters.nHits);
+    return *cached;
+  }
+  ++m_counters.nMisses;
+  auto data = fetch();
+  lru.insert(name, data, m_capacity);
+  return data;
+}
+
+void
+CtCache::invalidatePrefixes(const Name& name)
+{
+  for (size_t i = 0; i <= name.size(); i++) {
+    m_latest.erase(name.getPrefix(i));
+  }
+}
+
+void
+CtCache::addData(Data data)
+{
+  // keep a copy sharing the wire, the inner storage takes the Data
+  auto cached = std::make_shared<const Data>(data);
+  m_inner->addData(std::move(data));
+  m_exact.insert(cached->getName(), cached, m_capacity);
+  invalidatePrefixes(cached->getName());
+}
+
+std::shared_ptr<const Data>
+CtCache::findData(const Name& name)
+{
+  return lookup(m_exact, name, [this, &name] { return m_inner->findData(name); });
+}
+
+std::shared_ptr<const Data>
+CtCache::findLatestData(const Name& prefix)
+{
+  return lookup(m_latest, prefix, [this, &prefix] { return m_inner->findLatestData(prefix); });
+}
+
+void
+CtCache::deleteData(const Name& name)
+{
+  m_inner->deleteData(name);
+  m_exact.insert(name, nullptr, m_capacity);
+  invalidatePrefixes(name);
+}
+
+void
+CtCache::visitNames(const Name& prefix, const NameVisitor& visitor)
+{
+  m_inner->visitNames(prefix, visitor);
+}
+
+void
+CtCache::commit()
+{
+  m_inner->commit();
+}
+
+std::vector<Name>
+CtCache::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  return m_inner->listNames(prefix, after, limit);
+}
+
+optional<Name>
+CtCache::findPrecedingName(const Name& prefix, const Name& name)
+{
+  return m_inner->findPrecedingName(prefix, name);
+}
+
+} // namespace ct
+} // namespace ndnrevoke
@@ -0,0 +1,145 @@
+#ifndef NDNREVOKE_CT_CACHE_HPP
+#define NDNREVOKE_CT_CACHE_HPP
+
+#include "ct-storage.hpp"
+
+#include <list>
+#include <unordered_map>
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Size-bounded LRU cache in front of another CT storage.
+ *
+ * Created as "ct-storage-cached:<inner-type>".  Exact and prefix lookups are cached
+ * separately, each holding up to getCapacity() entries, and both remember misses as
+ * negative entries, so a cached lookup never reaches the inner storage.  addData and
+ * deleteData go through to the inner storage and then update the exact entry and drop
+ * the prefix entries of every prefix of the name.
+ *
+ * The capacity is taken from the "cache-capacity" factory parameter when present.
+ */
+class CtCache : public CtStorage
+{
+public:
+  CtCache(std::unique_ptr<CtStorage> inner, const Name& ctName = Name(), const std::string& path = "",
+          const Parameters& parameters = {});
+  const static std::string STORAGE_TYPE;
+
+public:
+  void
+  addData(Data data) override;
+
+  std::shared_ptr<const Data>
+  findData(const Name& name) override;
+
+  std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) override;
+
+  void
+  deleteData(const Name& name) override;
+
+  void
+  visitNames(const Name& prefix, const NameVisitor& visitor) override;
+
+  std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit) override;
+
+  optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name) override;
+
+  void
+  commit() override;
+
+public:
+  static const size_t DEFAULT_CAPACITY;
+  static const std::string CAPACITY_PARAMETER;
+
+  struct Counters
+  {
+    uint64_t nHits = 0;
+    uint64_t nNegativeHits = 0;
+    uint64_t nMisses = 0;
+  };
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  /**
+   * @return the ratio of lookups answered from the cache, positive or negative
+   */
+  double
+  getHitRatio() const;
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  void
+  setCapacity(size_t capacity);
+
+  CtStorage&
+  getInner()
+  {
+    return *m_inner;
+  }
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief LRU map from a name to a Data, where nullptr is a negative entry.
+   */
+  class Lru
+  {
+  public:
+    /**
+     * @return the cached entry, or nullopt
+     */
+    optional<std::shared_ptr<const Data>>
+    find(const Name& name);
+
+    void
+    insert(const Name& name, std::shared_ptr<const Data> data, size_t capacity);
+
+    void
+    erase(const Name& name);
+
+    void
+    shrink(size_t capacity);
+
+    size_t
+    size() const
+    {
+      return m_index.size();
+    }
+
+  private:
+    using Entry = std::pair<Name, std::shared_ptr<const Data>>;
+    // most recently used first
+    std::list<Entry> m_entries;
+    std::unordered_map<Name, std::list<Entry>::iterator> m_index;
+  };
+
+  std::shared_ptr<const Data>
+  lookup(Lru& lru, const Name& name, const std::function<std::shared_ptr<const Data>()>& fetch);
+
+  void
+  invalidatePrefixes(const Name& name);
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::unique_ptr<CtStorage> m_inner;
+  size_t m_capacity = DEFAULT_CAPACITY;
+  Lru m_exact;
+  Lru m_latest;
+  Counters m_counters;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_CT_CACHE_HPP
@@ -0,0 +1,38 @@
+#include "ct-cursor.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+CtCursor::CtCursor(CtStorage& storage, const Name& prefix, const optional<Name>& position)
+  : m_storage(storage)
+  , m_prefix(prefix)
+  , m_position(position)
+{
+}
+
+std::vector<std::shared_ptr<const Data>>
+CtCursor::next(size_t limit)
+{
+  std::vector<std::shared_ptr<const Data>> page;
+  if (limit == 0) {
+    return page;
+  }
+  // a listed name may be deleted before its Data is read, keep listing until the page has some
+  while (!m_isDone && page.empty()) {
+    auto names = m_storage.listNames(m_prefix, m_position, limit);
+    m_isDone = names.size() < limit;
+    for (const auto& name : names) {
+      auto data = m_storage.findData(name);
+      if (data != nullptr) {
+        page.push_back(std::move(data));
+      }
+    }
+    if (!names.empty()) {
+      m_position = names.back();
+    }
+  }
+  return page;
+}
+
+} // namespace ct
+} // namespace ndnrevoke
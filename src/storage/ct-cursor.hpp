@@ -0,0 +1,60 @@
+#ifndef NDNREVOKE_CT_CURSOR_HPP
+#define NDNREVOKE_CT_CURSOR_HPP
+
+#include "ct-storage.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Resumable scan over the Data stored under a prefix, in NDN canonical order.
+ *
+ * Each call to next() reads one bounded page through CtStorage::listNames, so a long scan
+ * (dump, mirror, audit) can be spread over several events and never holds the whole result.
+ * The position of a cursor is the name of the last Data it returned: a cursor created at
+ * that position continues right after it, also in another process or after a restart.
+ * Data added or deleted between two pages is seen or skipped depending on its position.
+ */
+class CtCursor
+{
+public:
+  CtCursor(CtStorage& storage, const Name& prefix, const optional<Name>& position = nullopt);
+
+  /**
+   * @return up to @p limit Data following the position, empty only when the scan is done
+   */
+  std::vector<std::shared_ptr<const Data>>
+  next(size_t limit);
+
+  bool
+  isDone() const
+  {
+    return m_isDone;
+  }
+
+  const Name&
+  getPrefix() const
+  {
+    return m_prefix;
+  }
+
+  /**
+   * @return the name of the last Data returned, or nullopt before the first one
+   */
+  const optional<Name>&
+  getPosition() const
+  {
+    return m_position;
+  }
+
+private:
+  CtStorage& m_storage;
+  Name m_prefix;
+  optional<Name> m_position;
+  bool m_isDone = false;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_CT_CURSOR_HPP
@@ -0,0 +1,193 @@
+#include "ct-hash.hpp"
+
+#include <limits>
+
+namespace ndnrevoke {
+namespace ct {
+
+const std::string CtHash::STORAGE_TYPE = "ct-storage-hash";
+NDNREVOKE_REGISTER_CT_STORAGE(CtHash);
+
+const size_t CtHash::NOT_FOUND = std::numeric_limits<size_t>::max();
+const size_t CtHash::INITIAL_CAPACITY = 16;
+
+static std::string
+makeSortKey(const Name& name)
+{
+  auto key = CtStorage::encodeSortKey(name);
+  return std::string(key.begin(), key.end());
+}
+
+static Name
+parseSortKey(const std::string& key)
+{
+  return CtStorage::decodeSortKey(make_span(reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+}
+
+CtHash::CtHash(const Name& ctName, const std::string& path)
+  : CtStorage()
+  , m_tags(INITIAL_CAPACITY, 0)
+  , m_records(INITIAL_CAPACITY)
+{
+}
+
+uint64_t
+CtHash::makeTag(const Name& name)
+{
+  // 0 marks an empty slot
+  uint64_t tag = computeNameDigest(name);
+  return tag == 0 ? 1 : tag;
+}
+
+size_t
+CtHash::findSlot(const Name& name, uint64_t tag) const
+{
+  size_t mask = m_tags.size() - 1;
+  for (size_t slot = tag & mask; m_tags[slot] != 0; slot = (slot + 1) & mask) {
+    if (m_tags[slot] == tag && m_records[slot]->getName() == name) {
+      return slot;
+    }
+  }
+  return NOT_FOUND;
+}
+
+void
+CtHash::insertSlot(uint64_t tag, std::shared_ptr<const Data> data)
+{
+  size_t mask = m_tags.size() - 1;
+  size_t slot = tag & mask;
+  while (m_tags[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  m_tags[slot] = tag;
+  m_records[slot] = std::move(data);
+}
+
+void
+CtHash::eraseSlot(size_t slot)
+{
+  // backward shift: move each following entry into the hole unless that would put it
+  // before its home slot
+  size_t mask = m_tags.size() - 1;
+  size_t hole = slot;
+  for (size_t next = (hole + 1) & mask; m_tags[next] != 0; next = (next + 1) & mask) {
+    size_t home = m_tags[next] & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      m_tags[hole] = m_tags[next];
+      m_records[hole] = std::move(m_records[next]);
+      hole = next;
+    }
+  }
+  m_tags[hole] = 0;
+  m_records[hole].reset();
+}
+
+void
+CtHash::grow()
+{
+  std::vector<uint64_t> tags(m_tags.size() * 2, 0);
+  std::vector<std::shared_ptr<const Data>> records(m_records.size() * 2);
+  tags.swap(m_tags);
+  records.swap(m_records);
+  for (size_t i = 0; i < tags.size(); i++) {
+    if (tags[i] != 0) {
+      insertSlot(tags[i], std::move(records[i]));
+    }
+  }
+}
+
+void
+CtHash::addData(Data data)
+{
+  const Name& name = data.getName();
+  uint64_t tag = makeTag(name);
+  if (findSlot(name, tag) != NOT_FOUND) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " already exists"));
+  }
+  // keep the load factor at most 7/8
+  if ((m_size + 1) * 8 > m_tags.size() * 7) {
+    grow();
+  }
+  m_sortKeys.insert(makeSortKey(name));
+  data.wireEncode();
+  insertSlot(tag, std::make_shared<const Data>(std::move(data)));
+  m_size++;
+}
+
+std::shared_ptr<const Data>
+CtHash::findData(const Name& name)
+{
+  size_t slot = findSlot(name, makeTag(name));
+  return slot == NOT_FOUND ? nullptr : m_records[slot];
+}
+
+std::shared_ptr<const Data>
+CtHash::findLatestData(const Name& prefix)
+{
+  auto it = prefix.empty() ? m_sortKeys.end() : m_sortKeys.lower_bound(makeSortKey(prefix.getSuccessor()));
+  if (it == m_sortKeys.begin()) {
+    return nullptr;
+  }
+  Name name = parseSortKey(*std::prev(it));
+  if (!prefix.isPrefixOf(name)) {
+    return nullptr;
+  }
+  return findData(name);
+}
+
+void
+CtHash::deleteData(const Name& name)
+{
+  size_t slot = findSlot(name, makeTag(name));
+  if (slot == NOT_FOUND) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
+  }
+  eraseSlot(slot);
+  m_sortKeys.erase(makeSortKey(name));
+  m_size--;
+}
+
+void
+CtHash::visitNames(const Name& prefix, const NameVisitor& visitor)
+{
+  auto prefixKey = makeSortKey(prefix);
+  for (auto it = m_sortKeys.lower_bound(prefixKey);
+       it != m_sortKeys.end() && it->compare(0, prefixKey.size(), prefixKey) == 0; ++it) {
+    visitor(parseSortKey(*it));
+  }
+}
+
+std::vector<Name>
+CtHash::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  auto prefixKey = makeSortKey(prefix);
+  auto lowerKey = prefixKey;
+  if (after) {
+    // the smallest key greater than the key of after
+    lowerKey = std::max(lowerKey, makeSortKey(*after) + '\0');
+  }
+  std::vector<Name> names;
+  for (auto it = m_sortKeys.lower_bound(lowerKey);
+       it != m_sortKeys.end() && it->compare(0, prefixKey.size(), prefixKey) == 0 && names.size() < limit;
+       ++it) {
+    names.push_back(parseSortKey(*it));
+  }
+  return names;
+}
+
+optional<Name>
+CtHash::findPrecedingName(const Name& prefix, const Name& name)
+{
+  auto it = m_sortKeys.lower_bound(makeSortKey(name));
+  if (it == m_sortKeys.begin()) {
+    return nullopt;
+  }
+  Name preceding = parseSortKey(*std::prev(it));
+  if (!prefix.isPrefixOf(preceding)) {
+    return nullopt;
+  }
+  return preceding;
+}
+
+} // namespace ct
+} // namespace ndnrevoke
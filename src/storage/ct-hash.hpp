@@ -0,0 +1,82 @@
+#ifndef NDNREVOKE_CT_HASH_HPP
+#define NDNREVOKE_CT_HASH_HPP
+
+#include "ct-storage.hpp"
+
+#include <set>
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief In-memory CT storage keyed by the digest of the wire-encoded Data name.
+ *
+ * Records live in an open-addressing table with linear probing.  Digests are kept in an
+ * array of their own, so probing scans contiguous memory and a miss usually does not touch
+ * any record; a name comparison only confirms a digest match.  Deletion shifts the
+ * following entries back instead of leaving tombstones.
+ *
+ * Prefix lookups are served by an ordered side index holding the sort key of each name.
+ */
+class CtHash : public CtStorage
+{
+public:
+  CtHash(const Name& ctName = Name(), const std::string& path = "");
+  const static std::string STORAGE_TYPE;
+
+public:
+  void
+  addData(Data data) override;
+
+  std::shared_ptr<const Data>
+  findData(const Name& name) override;
+
+  std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) override;
+
+  void
+  deleteData(const Name& name) override;
+
+  void
+  visitNames(const Name& prefix, const NameVisitor& visitor) override;
+
+  std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit) override;
+
+  optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name) override;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  static uint64_t
+  makeTag(const Name& name);
+
+  /**
+   * @return the slot holding @p name, or NOT_FOUND
+   */
+  size_t
+  findSlot(const Name& name, uint64_t tag) const;
+
+  void
+  insertSlot(uint64_t tag, std::shared_ptr<const Data> data);
+
+  void
+  eraseSlot(size_t slot);
+
+  void
+  grow();
+
+  static const size_t NOT_FOUND;
+  static const size_t INITIAL_CAPACITY;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  // slot i is empty iff m_tags[i] is 0; the capacity is a power of two
+  std::vector<uint64_t> m_tags;
+  std::vector<std::shared_ptr<const Data>> m_records;
+  size_t m_size = 0;
+  std::set<std::string> m_sortKeys;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_CT_HASH_HPP
@@ -0,0 +1,127 @@
+#include "ct-index.hpp"
+#include "record.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+NDN_LOG_INIT(ndnrevoke.storage.index);
+
+static bool
+insertEntry(std::map<Name::Component, std::set<Name>>& index, const Name::Component& key, const Name& name)
+{
+  return index[key].insert(name).second;
+}
+
+static bool
+eraseEntry(std::map<Name::Component, std::set<Name>>& index, const Name::Component& key, const Name& name)
+{
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return false;
+  }
+  bool isErased = it->second.erase(name) > 0;
+  if (it->second.empty()) {
+    index.erase(it);
+  }
+  return isErased;
+}
+
+optional<CtIndex::Keys>
+CtIndex::extractKeys(const Data& data)
+{
+  if (!record::Record::isValidName(data.getName())) {
+    return nullopt;
+  }
+  try {
+    record::Record record(data);
+    const Name& name = data.getName();
+    // the issuer follows the key id
+    return Keys{name.get(record::Record::KEYID_OFFSET + 1),
+                name.get(record::Record::KEYID_OFFSET),
+                Name::Component(record.getPublicKeyHash())};
+  }
+  catch (const ndn::tlv::Error& e) {
+    NDN_LOG_DEBUG("Record " << data.getName() << " cannot be indexed: " << e.what());
+    return nullopt;
+  }
+}
+
+const std::map<Name::Component, std::set<Name>>&
+CtIndex::getIndex(Kind kind) const
+{
+  switch (kind) {
+    case Kind::ISSUER:
+      return m_issuers;
+    case Kind::KEY_ID:
+      return m_keyIds;
+    case Kind::PUBLIC_KEY_HASH:
+      return m_publicKeyHashes;
+  }
+  NDN_THROW(std::invalid_argument("Unknown CT index kind"));
+}
+
+void
+CtIndex::insert(const Data& data)
+{
+  auto keys = extractKeys(data);
+  if (!keys) {
+    return;
+  }
+  // the keys come from the name and the content, a name already indexed is left alone
+  if (!insertEntry(m_issuers, keys->issuer, data.getName())) {
+    return;
+  }
+  insertEntry(m_keyIds, keys->keyId, data.getName());
+  insertEntry(m_publicKeyHashes, keys->publicKeyHash, data.getName());
+  m_nRecords++;
+}
+
+void
+CtIndex::erase(const Data& data)
+{
+  auto keys = extractKeys(data);
+  if (!keys) {
+    return;
+  }
+  if (!eraseEntry(m_issuers, keys->issuer, data.getName())) {
+    return;
+  }
+  eraseEntry(m_keyIds, keys->keyId, data.getName());
+  eraseEntry(m_publicKeyHashes, keys->publicKeyHash, data.getName());
+  m_nRecords--;
+}
+
+std::vector<Name>
+CtIndex::find(Kind kind, const Name::Component& value, size_t limit,
+              const optional<Name>& after) const
+{
+  const auto& index = getIndex(kind);
+  std::vector<Name> names;
+  auto it = index.find(value);
+  if (it == index.end()) {
+    return names;
+  }
+  auto name = after ? it->second.upper_bound(*after) : it->second.begin();
+  for (; name != it->second.end() && names.size() < limit; ++name) {
+    names.push_back(*name);
+  }
+  return names;
+}
+
+optional<CtIndex::Kind>
+CtIndex::parseKind(const Name::Component& component)
+{
+  if (component == Name::Component("ISSUER")) {
+    return Kind::ISSUER;
+  }
+  if (component == Name::Component("KEYID")) {
+    return Kind::KEY_ID;
+  }
+  if (component == Name::Component("PUBKEY-HASH")) {
+    return Kind::PUBLIC_KEY_HASH;
+  }
+  return nullopt;
+}
+
+} // namespace ct
+} // namespace ndnrevoke
@@ -0,0 +1,84 @@
+#ifndef NDNREVOKE_CT_INDEX_HPP
+#define NDNREVOKE_CT_INDEX_HPP
+
+#include "revocation-common.hpp"
+
+#include <set>
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Secondary indexes of the revocation records stored in a CT.
+ *
+ * A revocation record /<prefix>/REVOKE/<keyid>/<issuer>/<version>/<revoker> is indexed by
+ * its issuer and key id name components and by the PublicKeyHash in its content, so that
+ * the records of a compromised issuer or key can be found without their names.  Each index
+ * is an ordered map, lookups and updates take O(log n).  Other Data is not indexed.
+ */
+class CtIndex
+{
+public:
+  enum class Kind {
+    ISSUER,
+    KEY_ID,
+    PUBLIC_KEY_HASH,
+  };
+
+  /**
+   * @brief Index @p data if it is a well-formed revocation record.
+   */
+  void
+  insert(const Data& data);
+
+  /**
+   * @brief Remove @p data, which must have been indexed with the same content.
+   */
+  void
+  erase(const Data& data);
+
+  /**
+   * @return up to @p limit names of the records whose @p kind is @p value, in canonical order,
+   *         starting after @p after if it is given
+   */
+  std::vector<Name>
+  find(Kind kind, const Name::Component& value, size_t limit,
+       const optional<Name>& after = nullopt) const;
+
+  size_t
+  size() const
+  {
+    return m_nRecords;
+  }
+
+  /**
+   * @return the index named @p component in a query, i.e. "ISSUER", "KEYID" or "PUBKEY-HASH"
+   */
+  static optional<Kind>
+  parseKind(const Name::Component& component);
+
+private:
+  struct Keys
+  {
+    Name::Component issuer;
+    Name::Component keyId;
+    Name::Component publicKeyHash;
+  };
+
+  static optional<Keys>
+  extractKeys(const Data& data);
+
+  const std::map<Name::Component, std::set<Name>>&
+  getIndex(Kind kind) const;
+
+private:
+  std::map<Name::Component, std::set<Name>> m_issuers;
+  std::map<Name::Component, std::set<Name>> m_keyIds;
+  std::map<Name::Component, std::set<Name>> m_publicKeyHashes;
+  size_t m_nRecords = 0;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_CT_INDEX_HPP
@@ -0,0 +1,261 @@
+#include "ct-ledger.hpp"
+
+#ifdef NDNREVOKE_HAVE_LEDGERS
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <future>
+
+namespace ndnrevoke {
+namespace ct {
+
+NDN_LOG_INIT(ndnrevoke.storage.ledger);
+
+const std::string CtLedger::STORAGE_TYPE = "ct-storage-ledger";
+NDNREVOKE_REGISTER_CT_STORAGE(CtLedger);
+
+const size_t CtLedger::MAX_BATCH_SIZE = ndn::MAX_NDN_PACKET_SIZE / 2;
+
+static const std::string LEDGER_MULTICAST_PREFIX = "/ndn/broadcast/cert-ledger-dag";
+static const std::string LEDGER_SCHEMA = "./schema/loggers.schema";
+
+CtLedger::CtLedger(const Name& ctName, const std::string& path)
+  : CtStorage()
+  , m_batchPrefix(Name(ctName).append("BATCH"))
+  , m_ownFace(std::make_unique<ndn::Face>())
+  , m_ownKeyChain(std::make_unique<ndn::KeyChain>())
+  , m_keyChain(m_ownKeyChain.get())
+{
+  boost::filesystem::path dbDir;
+  if (!path.empty()) {
+    dbDir = boost::filesystem::path(path);
+  }
+  else {
+    std::string dbName = ctName.toUri();
+    std::replace(dbName.begin(), dbName.end(), '/', '_');
+    dbName += "-ledger";
+    if (getenv("HOME") != nullptr) {
+      dbDir = boost::filesystem::path(getenv("HOME")) / ".ndnrevoke" / dbName;
+    }
+    else {
+      dbDir = boost::filesystem::current_path() / ".ndnrevoke" / dbName;
+    }
+  }
+
+  auto config = cert_ledger::Config::CustomizedConfig(LEDGER_MULTICAST_PREFIX, ctName.toUri(), dbDir.string());
+  auto validator = std::make_shared<ndn::security::ValidatorConfig>(*m_ownFace);
+  validator->load(LEDGER_SCHEMA);
+  m_ledger = std::make_unique<cert_ledger::CertLedger>(*config, *m_keyChain, *m_ownFace, validator);
+  loadBatches();
+
+  // the ledger keeps synchronizing with its peers in the background
+  m_ledgerThread = std::thread([this] { m_ownFace->processEvents(time::milliseconds::zero(), true); });
+}
+
+CtLedger::CtLedger(const Name& ctName, const cert_ledger::Config& config, ndn::KeyChain& keyChain,
+                   ndn::Face& face, std::shared_ptr<ndn::security::Validator> recordValidator)
+  : CtStorage()
+  , m_batchPrefix(Name(ctName).append("BATCH"))
+  , m_keyChain(&keyChain)
+  , m_ledger(std::make_unique<cert_ledger::CertLedger>(config, keyChain, face, recordValidator))
+{
+  loadBatches();
+}
+
+CtLedger::~CtLedger()
+{
+  try {
+    commit();
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Cannot commit pending records to the ledger: " << e.what());
+  }
+  if (m_ledgerThread.joinable()) {
+    m_ownFace->getIoService().post([this] {
+      m_ownFace->shutdown();
+      m_ownFace->getIoService().stop();
+    });
+    m_ledgerThread.join();
+  }
+}
+
+void
+CtLedger::runInLedgerThread(const std::function<void()>& func)
+{
+  if (!m_ledgerThread.joinable()) {
+    func();
+    return;
+  }
+  std::promise<void> promise;
+  auto result = promise.get_future();
+  m_ownFace->getIoService().post([&func, &promise] {
+    try {
+      func();
+      promise.set_value();
+    }
+    catch (...) {
+      promise.set_exception(std::current_exception());
+    }
+  });
+  result.get();
+}
+
+void
+CtLedger::loadBatches()
+{
+  auto listed = m_ledger->listRecord(m_batchPrefix);
+  // batches are replayed in the order they were committed
+  std::vector<Name> batchNames(listed.begin(), listed.end());
+  std::sort(batchNames.begin(), batchNames.end());
+  for (const auto& batchName : batchNames) {
+    auto record = m_ledger->getRecord(batchName);
+    if (!record) {
+      NDN_LOG_WARN("Ledger record " << batchName << " is listed but cannot be read");
+      continue;
+    }
+    Data batch = record->getContentItem();
+    if (!batch.getName().empty() && batch.getName().get(-1).isVersion()) {
+      m_lastVersion = std::max(m_lastVersion, batch.getName().get(-1).toVersion());
+    }
+    Block content = batch.getContent();
+    content.parse();
+    for (const auto& item : content.elements()) {
+      if (item.type() == ndn::tlv::Name) {
+        m_records.erase(Name(item));
+      }
+      else if (item.type() == ndn::tlv::Data) {
+        auto data = std::make_shared<const Data>(item);
+        m_records[data->getName()] = std::move(data);
+      }
+    }
+  }
+  NDN_LOG_TRACE("Loaded " << m_records.size() << " records from " << batchNames.size() << " ledger batches");
+}
+
+void
+CtLedger::commit()
+{
+  // a group commit may hold thousands of changes, which cannot all go in one packet
+  auto first = m_pendingBlocks.cbegin();
+  try {
+    while (first != m_pendingBlocks.cend()) {
+      auto last = first;
+      size_t size = 0;
+      while (last != m_pendingBlocks.cend() && (last == first || size + last->size() <= MAX_BATCH_SIZE)) {
+        size += last->size();
+        ++last;
+      }
+      appendBatch(first, last);
+      first = last;
+    }
+  }
+  catch (const std::exception&) {
+    // the appended batches are in the ledger, only the others are retried
+    m_pendingBlocks.erase(m_pendingBlocks.cbegin(), first);
+    throw;
+  }
+  m_pendingBlocks.clear();
+}
+
+void
+CtLedger::appendBatch(std::vector<Block>::const_iterator first, std::vector<Block>::const_iterator last)
+{
+  // versions must grow even when two batches are committed within a millisecond
+  m_lastVersion = std::max<uint64_t>(m_lastVersion + 1,
+                                     time::toUnixTimestamp(time::system_clock::now()).count());
+  Data batch(Name(m_batchPrefix).appendVersion(m_lastVersion));
+  Block content(ndn::tlv::Content);
+  for (auto block = first; block != last; ++block) {
+    content.push_back(*block);
+  }
+  content.encode();
+  batch.setContent(content);
+  m_keyChain->sign(batch, ndn::security::signingWithSha256());
+
+  runInLedgerThread([this, &batch] {
+    cert_ledger::Record record(m_ledger->getPeerPrefix(), batch);
+    auto code = m_ledger->createRecord(record);
+    if (!code.success()) {
+      NDN_THROW(std::runtime_error(std::string("Ledger cannot append batch: ") + code.what()));
+    }
+  });
+  NDN_LOG_DEBUG("Committed " << std::distance(first, last) << " changes in ledger batch " << batch.getName());
+}
+
+void
+CtLedger::addData(Data data)
+{
+  Name name = data.getName();
+  auto search = m_records.lower_bound(name);
+  if (search != m_records.end() && search->first == name) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " already exists"));
+  }
+  m_pendingBlocks.push_back(data.wireEncode());
+  m_records.emplace_hint(search, std::move(name), std::make_shared<const Data>(std::move(data)));
+}
+
+std::shared_ptr<const Data>
+CtLedger::findData(const Name& name)
+{
+  auto search = m_records.find(name);
+  return search == m_records.end() ? nullptr : search->second;
+}
+
+std::shared_ptr<const Data>
+CtLedger::findLatestData(const Name& prefix)
+{
+  auto it = prefix.empty() ? m_records.end() : m_records.lower_bound(prefix.getSuccessor());
+  if (it == m_records.begin() || !prefix.isPrefixOf(std::prev(it)->first)) {
+    return nullptr;
+  }
+  return std::prev(it)->second;
+}
+
+void
+CtLedger::deleteData(const Name& name)
+{
+  auto search = m_records.find(name);
+  if (search == m_records.end()) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
+  }
+  // the ledger is append-only, a deletion is recorded as a tombstone Name block
+  m_pendingBlocks.push_back(name.wireEncode());
+  m_records.erase(search);
+}
+
+void
+CtLedger::visitNames(const Name& prefix, const NameVisitor& visitor)
+{
+  for (auto it = m_records.lower_bound(prefix); it != m_records.end() && prefix.isPrefixOf(it->first); ++it) {
+    visitor(it->first);
+  }
+}
+
+std::vector<Name>
+CtLedger::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  auto it = after && *after >= prefix ? m_records.upper_bound(*after) : m_records.lower_bound(prefix);
+  std::vector<Name> names;
+  for (; it != m_records.end() && prefix.isPrefixOf(it->first) && names.size() < limit; ++it) {
+    names.push_back(it->first);
+  }
+  return names;
+}
+
+optional<Name>
+CtLedger::findPrecedingName(const Name& prefix, const Name& name)
+{
+  // a name past the prefix range is bounded by the end of that range
+  auto it = m_records.lower_bound(prefix.isPrefixOf(name) || name < prefix ? name : prefix.getSuccessor());
+  if (it == m_records.begin() || !prefix.isPrefixOf(std::prev(it)->first)) {
+    return nullopt;
+  }
+  return std::prev(it)->first;
+}
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_HAVE_LEDGERS
@@ -0,0 +1,106 @@
+#ifndef NDNREVOKE_CT_LEDGER_HPP
+#define NDNREVOKE_CT_LEDGER_HPP
+
+#include "ct-storage.hpp"
+
+#ifdef NDNREVOKE_HAVE_LEDGERS
+
+#include "cert-ledger/cert-ledger.hpp"
+
+#include <thread>
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief CT storage replicated through a cert-ledger DAG.
+ *
+ * Changes are batched: addData and deleteData only queue a Data wire or a tombstone Name
+ * block, and commit() appends the queued blocks as the content of ledger records named
+ * /<ct-name>/BATCH/<version>, as few as the packet size allows.  Every record is also kept in a local index, which
+ * serves all lookups, so queries never wait on ledger synchronization.  On startup the
+ * index is rebuilt by replaying the batches found in the ledger.
+ *
+ * Constructed through the factory, the storage owns its Face and KeyChain and runs the
+ * ledger on a thread of its own; @p path is the ledger database directory.
+ */
+class CtLedger : public CtStorage
+{
+public:
+  CtLedger(const Name& ctName = Name(), const std::string& path = "");
+
+  CtLedger(const Name& ctName, const cert_ledger::Config& config, ndn::KeyChain& keyChain,
+           ndn::Face& face, std::shared_ptr<ndn::security::Validator> recordValidator);
+
+  const static std::string STORAGE_TYPE;
+
+  ~CtLedger() override;
+
+public:
+  void
+  addData(Data data) override;
+
+  std::shared_ptr<const Data>
+  findData(const Name& name) override;
+
+  std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) override;
+
+  void
+  deleteData(const Name& name) override;
+
+  void
+  visitNames(const Name& prefix, const NameVisitor& visitor) override;
+
+  std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit) override;
+
+  optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name) override;
+
+  void
+  commit() override;
+
+public:
+  // content bytes of a batch, leaving room for the ledger record that wraps it
+  static const size_t MAX_BATCH_SIZE;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief Append the blocks in [@p first, @p last) to the ledger as one batch.
+   */
+  void
+  appendBatch(std::vector<Block>::const_iterator first, std::vector<Block>::const_iterator last);
+
+  /**
+   * @brief Rebuild the local index from the batches stored in the ledger.
+   */
+  void
+  loadBatches();
+
+  /**
+   * @brief Run @p func where the ledger is allowed to be used, and wait for it.
+   */
+  void
+  runInLedgerThread(const std::function<void()>& func);
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  Name m_batchPrefix;
+  // only set when the storage runs the ledger on its own thread
+  std::unique_ptr<ndn::Face> m_ownFace;
+  std::unique_ptr<ndn::KeyChain> m_ownKeyChain;
+  ndn::KeyChain* m_keyChain = nullptr;
+  std::unique_ptr<cert_ledger::CertLedger> m_ledger;
+  std::thread m_ledgerThread;
+
+  std::map<Name, std::shared_ptr<const Data>> m_records;
+  std::vector<Block> m_pendingBlocks;
+  uint64_t m_lastVersion = 0;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_HAVE_LEDGERS
+
+#endif // NDNREVOKE_CT_LEDGER_HPP
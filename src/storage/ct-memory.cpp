@@ -1,45 +1,273 @@
 #include "ct-memory.hpp"
 
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace ndnrevoke {
 namespace ct {
 
+NDN_LOG_INIT(ndnrevoke.storage.memory);
+
 const std::string CtMemory::STORAGE_TYPE = "ct-storage-memory";
 NDNREVOKE_REGISTER_CT_STORAGE(CtMemory);
 
+const size_t CtMemory::SNAPSHOT_WAL_SIZE = 64 * 1024 * 1024;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void
+writeAll(int fd, const uint8_t* buffer, size_t size, uint64_t offset)
+{
+  while (size > 0) {
+    ssize_t written = ::pwrite(fd, buffer, size, static_cast<off_t>(offset));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      NDN_THROW(std::runtime_error("Cannot write CT log: " + std::string(std::strerror(errno))));
+    }
+    buffer += written;
+    size -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+}
+
+} // namespace
+
 CtMemory::CtMemory(const Name& ctName, const std::string& path)
   : CtStorage()
 {
+  if (path.empty()) {
+    return;
+  }
+  fs::create_directories(path);
+  m_snapshotFileName = (fs::path(path) / "snapshot").string();
+  m_walFileName = (fs::path(path) / "wal").string();
+  fs::remove(m_snapshotFileName + ".tmp");
+
+  if (fs::exists(m_snapshotFileName)) {
+    m_snapshotSize = loadFile(m_snapshotFileName);
+  }
+  if (fs::exists(m_walFileName)) {
+    m_walSize = loadFile(m_walFileName);
+    if (m_walSize < fs::file_size(m_walFileName)) {
+      NDN_LOG_WARN("Truncating incomplete tail of " << m_walFileName << " at " << m_walSize);
+      fs::resize_file(m_walFileName, m_walSize);
+    }
+  }
+  m_walFd = ::open(m_walFileName.data(), O_WRONLY | O_CREAT, 0644);
+  if (m_walFd < 0) {
+    NDN_THROW(std::runtime_error("Cannot open CT log " + m_walFileName));
+  }
+  NDN_LOG_TRACE("Restored " << m_records.size() << " records from " << path);
+}
+
+CtMemory::~CtMemory()
+{
+  if (m_walFd >= 0) {
+    try {
+      commit();
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Cannot commit CT log on close: " << e.what());
+    }
+    ::close(m_walFd);
+  }
+}
+
+size_t
+CtMemory::loadFile(const std::string& fileName)
+{
+  // one buffer backs all the records of the file, blocks only point into it
+  auto buffer = std::make_shared<Buffer>(fs::file_size(fileName));
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(buffer->size()))) {
+    NDN_THROW(std::runtime_error("Cannot read " + fileName));
+  }
+
+  size_t offset = 0;
+  while (offset < buffer->size()) {
+    bool isOk = false;
+    Block block;
+    std::tie(isOk, block) = Block::fromBuffer(buffer, offset);
+    if (!isOk) {
+      break;
+    }
+    try {
+      if (block.type() == ndn::tlv::Name) {
+        m_records.erase(Name(block));
+      }
+      else {
+        m_records.insert(std::make_shared<const Data>(block));
+      }
+    }
+    catch (const ndn::tlv::Error&) {
+      break;
+    }
+    offset += block.size();
+  }
+  return offset;
 }
 
 void
-CtMemory::addData(const Data& data)
+CtMemory::appendToWal(const Block& block)
 {
-  Name name = data.getName();
-  auto search = m_list.find(name);
-  if (search != m_list.end()) {
-    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " already exists"));
+  if (m_walFd >= 0) {
+    m_pendingWal.insert(m_pendingWal.end(), block.begin(), block.end());
   }
-  m_list.insert(std::make_pair(name, data));
 }
 
-Data
-CtMemory::getData(const Name& name)
+void
+CtMemory::commit()
 {
-  auto search = m_list.find(name);
-  if (search == m_list.end()) {
-    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
+  if (m_walFd < 0 || m_pendingWal.empty()) {
+    return;
+  }
+  writeAll(m_walFd, m_pendingWal.data(), m_pendingWal.size(), m_walSize);
+  if (::fdatasync(m_walFd) < 0) {
+    NDN_THROW(std::runtime_error("Cannot sync CT log: " + std::string(std::strerror(errno))));
+  }
+  m_walSize += m_pendingWal.size();
+  m_pendingWal.clear();
+
+  if (m_walSize >= std::max<uint64_t>(m_snapshotWalSize, m_snapshotSize)) {
+    writeSnapshot();
   }
-  return search->second;
+}
+
+void
+CtMemory::writeSnapshot()
+{
+  auto tmpFileName = m_snapshotFileName + ".tmp";
+  int fd = ::open(tmpFileName.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    NDN_THROW(std::runtime_error("Cannot create " + tmpFileName));
+  }
+  uint64_t offset = 0;
+  try {
+    m_records.visit(Name(), true, [&] (const std::shared_ptr<const Data>& data) {
+      const Block& wire = data->wireEncode();
+      writeAll(fd, &*wire.begin(), wire.size(), offset);
+      offset += wire.size();
+      return true;
+    });
+  }
+  catch (const std::exception&) {
+    ::close(fd);
+    fs::remove(tmpFileName);
+    throw;
+  }
+  if (::fsync(fd) < 0) {
+    int error = errno;
+    ::close(fd);
+    fs::remove(tmpFileName);
+    NDN_THROW(std::runtime_error("Cannot sync " + tmpFileName + ": " + std::strerror(error)));
+  }
+  ::close(fd);
+  fs::rename(tmpFileName, m_snapshotFileName);
+
+  // the rename is durable only once the directory is synced
+  auto dirName = fs::path(m_snapshotFileName).parent_path().string();
+  int dirFd = ::open(dirName.empty() ? "." : dirName.data(), O_RDONLY | O_DIRECTORY);
+  if (dirFd < 0) {
+    NDN_THROW(std::runtime_error("Cannot open " + dirName + ": " + std::strerror(errno)));
+  }
+  if (::fsync(dirFd) < 0) {
+    int error = errno;
+    ::close(dirFd);
+    NDN_THROW(std::runtime_error("Cannot sync " + dirName + ": " + std::strerror(error)));
+  }
+  ::close(dirFd);
+
+  // the log replays idempotently over the snapshot, a crash before this point is harmless
+  if (::ftruncate(m_walFd, 0) < 0 || ::fdatasync(m_walFd) < 0) {
+    NDN_THROW(std::runtime_error("Cannot truncate CT log: " + std::string(std::strerror(errno))));
+  }
+  m_walSize = 0;
+  m_snapshotSize = offset;
+  NDN_LOG_DEBUG("Wrote CT snapshot of " << m_records.size() << " records");
+}
+
+void
+CtMemory::addData(Data data)
+{
+  if (m_records.find(data.getName()) != nullptr) {
+    NDN_THROW(std::runtime_error("Data for " + data.getName().toUri() + " already exists"));
+  }
+  // encode before sharing, lookups hand out the cached wire
+  appendToWal(data.wireEncode());
+  m_records.insert(std::make_shared<const Data>(std::move(data)));
+}
+
+std::shared_ptr<const Data>
+CtMemory::findData(const Name& name)
+{
+  return m_records.find(name);
+}
+
+std::shared_ptr<const Data>
+CtMemory::findLatestData(const Name& prefix)
+{
+  return m_records.findLast(prefix);
 }
 
 void
 CtMemory::deleteData(const Name& name)
 {
-  auto search = m_list.find(name);
-  if (search == m_list.end()) {
+  if (m_records.find(name) == nullptr) {
     NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
   }
-  m_list.erase(search);
+  // a Name block is the tombstone of a record
+  appendToWal(name.wireEncode());
+  m_records.erase(name);
+}
+
+void
+CtMemory::visitNames(const Name& prefix, const NameVisitor& visitor)
+{
+  m_records.visit(prefix, true, [&] (const std::shared_ptr<const Data>& data) {
+    if (!prefix.isPrefixOf(data->getName())) {
+      return false;
+    }
+    visitor(data->getName());
+    return true;
+  });
+}
+
+std::vector<Name>
+CtMemory::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  std::vector<Name> names;
+  if (limit == 0) {
+    return names;
+  }
+  bool isAfter = after && *after >= prefix;
+  m_records.visit(isAfter ? *after : prefix, !isAfter, [&] (const std::shared_ptr<const Data>& data) {
+    if (!prefix.isPrefixOf(data->getName())) {
+      return false;
+    }
+    names.push_back(data->getName());
+    return names.size() < limit;
+  });
+  return names;
+}
+
+optional<Name>
+CtMemory::findPrecedingName(const Name& prefix, const Name& name)
+{
+  auto data = m_records.findBefore(name);
+  if (data == nullptr || !prefix.isPrefixOf(data->getName())) {
+    return nullopt;
+  }
+  return data->getName();
 }
 
 } // namespace ct
@@ -2,28 +2,94 @@
 #define NDNREVOKE_CT_MEMORY_HPP
 
 #include "ct-storage.hpp"
+#include "record-treap.hpp"
 
 namespace ndnrevoke {
 namespace ct {
 
+/**
+ * @brief In-memory CT storage.
+ *
+ * If @p path is given, the storage is made durable in that directory: every change is
+ * appended to a write-ahead log, which commit() flushes and syncs, so several changes share
+ * one sync.  Once the log outgrows the last snapshot (and SNAPSHOT_WAL_SIZE), a compact
+ * snapshot of the live records is written and the log is truncated.  On startup the snapshot
+ * is loaded into one buffer shared by the restored records and the log tail is replayed.
+ *
+ * Records are kept in a persistent RecordTreap, so getSnapshot() hands out a consistent read
+ * view in O(1) that exporters, replication and audits can scan, also from another thread,
+ * while records keep being added and deleted.
+ */
 class CtMemory : public CtStorage
 {
 public:
   CtMemory(const Name& ctName = Name(), const std::string& path = "");
   const static std::string STORAGE_TYPE;
 
+  ~CtMemory() override;
+
 public:
   void
-  addData(const Data& data) override;
+  addData(Data data) override;
+
+  std::shared_ptr<const Data>
+  findData(const Name& name) override;
 
-  Data
-  getData(const Name& name) override;
+  std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) override;
 
   void
   deleteData(const Name& name) override;
 
-private:
-  std::map<Name, Data> m_list;
+  void
+  visitNames(const Name& prefix, const NameVisitor& visitor) override;
+
+  std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit) override;
+
+  optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name) override;
+
+  void
+  commit() override;
+
+  /**
+   * @return a read view of the records, unaffected by later changes
+   */
+  RecordTreap
+  getSnapshot() const
+  {
+    return m_records;
+  }
+
+public:
+  static const size_t SNAPSHOT_WAL_SIZE;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief Apply the Data and tombstone blocks in @p fileName.
+   * @return size of the complete blocks in the file
+   */
+  size_t
+  loadFile(const std::string& fileName);
+
+  void
+  appendToWal(const Block& block);
+
+  void
+  writeSnapshot();
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  RecordTreap m_records;
+
+  // durability, only when a path is given
+  std::string m_walFileName;
+  std::string m_snapshotFileName;
+  int m_walFd = -1;
+  uint64_t m_walSize = 0;
+  Buffer m_pendingWal;
+  uint64_t m_snapshotSize = 0;
+  size_t m_snapshotWalSize = SNAPSHOT_WAL_SIZE;
 };
 
 } // namespace ct
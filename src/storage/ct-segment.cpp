@@ -0,0 +1,939 @@
+#include "ct-segment.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndnrevoke {
+namespace ct {
+
+NDN_LOG_INIT(ndnrevoke.storage.segment);
+
+const std::string CtSegment::STORAGE_TYPE = "ct-storage-segment";
+NDNREVOKE_REGISTER_CT_STORAGE(CtSegment);
+
+const size_t CtSegment::SEGMENT_SIZE_LIMIT = 64 * 1024 * 1024;
+const size_t CtSegment::COMPACTION_THRESHOLD = 4;
+
+namespace fs = boost::filesystem;
+
+static const uint64_t INDEX_MAGIC = 0x5844495645524e44; // "NDREVIDX"
+static const uint32_t INDEX_VERSION = 2;
+static const uint32_t FLAG_TOMBSTONE = 1;
+static const std::string DATA_EXTENSION = ".data";
+static const std::string INDEX_EXTENSION = ".index";
+static const std::string TMP_EXTENSION = ".tmp";
+
+namespace {
+
+struct IndexHeader
+{
+  uint64_t magic;
+  uint32_t version;
+  uint32_t nEntries;
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ */
+class MappedFile : boost::noncopyable
+{
+public:
+  explicit
+  MappedFile(const std::string& fileName)
+  {
+    int fd = ::open(fileName.data(), O_RDONLY);
+    if (fd < 0) {
+      NDN_THROW(std::runtime_error("Cannot open " + fileName));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+      ::close(fd);
+      NDN_THROW(std::runtime_error("Cannot stat " + fileName));
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size > 0) {
+      void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        NDN_THROW(std::runtime_error("Cannot map " + fileName));
+      }
+      m_data = static_cast<const uint8_t*>(addr);
+    }
+    ::close(fd);
+  }
+
+  ~MappedFile()
+  {
+    if (m_data != nullptr) {
+      ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+  }
+
+  const uint8_t*
+  data() const
+  {
+    return m_data;
+  }
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+private:
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+};
+
+void
+writeAll(int fd, const uint8_t* buffer, size_t size, uint64_t offset)
+{
+  while (size > 0) {
+    ssize_t written = ::pwrite(fd, buffer, size, static_cast<off_t>(offset));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      NDN_THROW(std::runtime_error("Cannot write segment file: " + std::string(std::strerror(errno))));
+    }
+    buffer += written;
+    size -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+}
+
+void
+syncFile(int fd, const std::string& fileName)
+{
+  if (::fsync(fd) < 0) {
+    NDN_THROW(std::runtime_error("Cannot sync " + fileName + ": " + std::strerror(errno)));
+  }
+}
+
+/**
+ * @brief Sync the directory holding @p fileName, so that a file renamed into it is durable.
+ */
+void
+syncParentDirectory(const std::string& fileName)
+{
+  auto dirName = fs::path(fileName).parent_path().string();
+  int dirFd = ::open(dirName.empty() ? "." : dirName.data(), O_RDONLY | O_DIRECTORY);
+  if (dirFd < 0) {
+    NDN_THROW(std::runtime_error("Cannot open " + dirName + ": " + std::strerror(errno)));
+  }
+  try {
+    syncFile(dirFd, dirName);
+  }
+  catch (const std::exception&) {
+    ::close(dirFd);
+    throw;
+  }
+  ::close(dirFd);
+}
+
+/**
+ * @brief Write an index made of the entries sorted by digest, followed by the positions
+ *        of the entries in name order.
+ */
+void
+writeIndex(const std::string& fileName, std::vector<std::pair<Name, CtSegment::IndexEntry>> namedEntries)
+{
+  std::sort(namedEntries.begin(), namedEntries.end(),
+            [] (const auto& a, const auto& b) { return a.first < b.first; });
+  std::vector<uint32_t> byDigest(namedEntries.size());
+  std::iota(byDigest.begin(), byDigest.end(), 0);
+  std::sort(byDigest.begin(), byDigest.end(), [&namedEntries] (uint32_t a, uint32_t b) {
+    return namedEntries[a].second.digest < namedEntries[b].second.digest;
+  });
+  std::vector<CtSegment::IndexEntry> entries;
+  std::vector<uint32_t> nameOrder(namedEntries.size());
+  entries.reserve(namedEntries.size());
+  for (uint32_t position : byDigest) {
+    nameOrder[position] = static_cast<uint32_t>(entries.size());
+    entries.push_back(namedEntries[position].second);
+  }
+  IndexHeader header{INDEX_MAGIC, INDEX_VERSION, static_cast<uint32_t>(entries.size())};
+
+  // write aside and rename, so that an index file on disk is always complete
+  std::string tmpFileName = fileName + TMP_EXTENSION;
+  int fd = ::open(tmpFileName.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    NDN_THROW(std::runtime_error("Cannot create " + tmpFileName));
+  }
+  try {
+    writeAll(fd, reinterpret_cast<const uint8_t*>(&header), sizeof(header), 0);
+    uint64_t offset = sizeof(header);
+    writeAll(fd, reinterpret_cast<const uint8_t*>(entries.data()),
+             entries.size() * sizeof(CtSegment::IndexEntry), offset);
+    offset += entries.size() * sizeof(CtSegment::IndexEntry);
+    writeAll(fd, reinterpret_cast<const uint8_t*>(nameOrder.data()),
+             nameOrder.size() * sizeof(uint32_t), offset);
+    syncFile(fd, tmpFileName);
+  }
+  catch (const std::exception&) {
+    ::close(fd);
+    fs::remove(tmpFileName);
+    throw;
+  }
+  ::close(fd);
+  fs::rename(tmpFileName, fileName);
+  syncParentDirectory(fileName);
+}
+
+/**
+ * @brief Get the name of a Data block or of a tombstone Name block.
+ */
+Name
+getBlockName(Block& block)
+{
+  if (block.type() == ndn::tlv::Name) {
+    return Name(block);
+  }
+  if (block.type() != ndn::tlv::Data) {
+    NDN_THROW(ndn::tlv::Error("Unexpected TLV Type in segment: " + std::to_string(block.type())));
+  }
+  block.parse();
+  return Name(block.get(ndn::tlv::Name));
+}
+
+/**
+ * @brief Get the name of a Data or tombstone wire without copying the rest of it.
+ */
+Name
+readBlockName(span<const uint8_t> wire)
+{
+  const uint8_t* pos = wire.data();
+  const uint8_t* end = pos + wire.size();
+  uint32_t type = ndn::tlv::readType(pos, end);
+  if (type == ndn::tlv::Data) {
+    // the Name is the first element of the Data
+    ndn::tlv::readVarNumber(pos, end);
+    return Name(Block(make_span(pos, static_cast<size_t>(end - pos))));
+  }
+  if (type != ndn::tlv::Name) {
+    NDN_THROW(ndn::tlv::Error("Unexpected TLV Type in segment: " + std::to_string(type)));
+  }
+  return Name(Block(wire));
+}
+
+} // namespace
+
+class CtSegment::Segment : boost::noncopyable
+{
+public:
+  Segment(uint64_t first, uint64_t last, const std::string& dataFileName, const std::string& indexFileName)
+    : first(first)
+    , last(last)
+    , dataFileName(dataFileName)
+    , indexFileName(indexFileName)
+    , m_data(dataFileName)
+    , m_index(indexFileName)
+  {
+    IndexHeader header;
+    if (m_index.size() < sizeof(header)) {
+      NDN_THROW(std::runtime_error("Truncated segment index " + indexFileName));
+    }
+    std::memcpy(&header, m_index.data(), sizeof(header));
+    if (header.magic != INDEX_MAGIC || header.version != INDEX_VERSION ||
+        m_index.size() < sizeof(header) + header.nEntries * (sizeof(IndexEntry) + sizeof(uint32_t))) {
+      NDN_THROW(std::runtime_error("Corrupted segment index " + indexFileName));
+    }
+    m_entries = reinterpret_cast<const IndexEntry*>(m_index.data() + sizeof(header));
+    m_nameOrder = reinterpret_cast<const uint32_t*>(m_entries + header.nEntries);
+    m_nEntries = header.nEntries;
+  }
+
+  const IndexEntry*
+  begin() const
+  {
+    return m_entries;
+  }
+
+  const IndexEntry*
+  end() const
+  {
+    return m_entries + m_nEntries;
+  }
+
+  /**
+   * @brief Binary search for the entries carrying @p digest.
+   */
+  std::pair<const IndexEntry*, const IndexEntry*>
+  equalRange(uint64_t digest) const
+  {
+    struct DigestLess
+    {
+      bool
+      operator()(const IndexEntry& entry, uint64_t digest) const
+      {
+        return entry.digest < digest;
+      }
+
+      bool
+      operator()(uint64_t digest, const IndexEntry& entry) const
+      {
+        return digest < entry.digest;
+      }
+    };
+    return std::equal_range(begin(), end(), digest, DigestLess{});
+  }
+
+  size_t
+  dataSize() const
+  {
+    return m_data.size();
+  }
+
+  span<const uint8_t>
+  read(const IndexEntry& entry) const
+  {
+    if (entry.offset + entry.length > m_data.size()) {
+      NDN_THROW(std::runtime_error("Segment entry out of range in " + dataFileName));
+    }
+    return make_span(m_data.data() + entry.offset, entry.length);
+  }
+
+  uint32_t
+  size() const
+  {
+    return m_nEntries;
+  }
+
+  /**
+   * @return the entry at @p position in name order
+   */
+  const IndexEntry&
+  entryAt(uint32_t position) const
+  {
+    return m_entries[m_nameOrder[position]];
+  }
+
+  Name
+  nameAt(uint32_t position) const
+  {
+    return readBlockName(read(entryAt(position)));
+  }
+
+  /**
+   * @brief Binary search for the position, in name order, of the first entry not before
+   *        @p name, or after it if @p isExclusive.
+   */
+  uint32_t
+  seek(const Name& name, bool isExclusive) const
+  {
+    uint32_t low = 0;
+    uint32_t high = m_nEntries;
+    while (low < high) {
+      uint32_t mid = low + (high - low) / 2;
+      Name midName = nameAt(mid);
+      if (midName < name || (isExclusive && midName == name)) {
+        low = mid + 1;
+      }
+      else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  /**
+   * @brief Binary search, in name order, for the last entry under @p prefix that is
+   *        before @p limit (or the end of the prefix range if @p limit is not given).
+   */
+  const IndexEntry*
+  findLastBefore(const Name& prefix, const optional<Name>& limit) const
+  {
+    uint32_t low = 0;
+    uint32_t high = m_nEntries;
+    if (limit || !prefix.empty()) {
+      Name bound = limit ? *limit : prefix.getSuccessor();
+      while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (nameAt(mid) < bound) {
+          low = mid + 1;
+        }
+        else {
+          high = mid;
+        }
+      }
+    }
+    if (high == 0 || !prefix.isPrefixOf(nameAt(high - 1))) {
+      return nullptr;
+    }
+    return &m_entries[m_nameOrder[high - 1]];
+  }
+
+public:
+  const uint64_t first;
+  const uint64_t last;
+  const std::string dataFileName;
+  const std::string indexFileName;
+
+private:
+  MappedFile m_data;
+  MappedFile m_index;
+  const IndexEntry* m_entries = nullptr;
+  const uint32_t* m_nameOrder = nullptr;
+  uint32_t m_nEntries = 0;
+};
+
+CtSegment::CtSegment(const Name& ctName, const std::string& path)
+  : CtStorage()
+{
+  fs::path dir;
+  if (!path.empty()) {
+    dir = fs::path(path);
+  }
+  else {
+    std::string dirName = ctName.toUri();
+    std::replace(dirName.begin(), dirName.end(), '/', '_');
+    dirName += "-segments";
+    if (getenv("HOME") != nullptr) {
+      dir = fs::path(getenv("HOME")) / ".ndnrevoke" / dirName;
+    }
+    else {
+      dir = fs::current_path() / ".ndnrevoke" / dirName;
+    }
+  }
+  fs::create_directories(dir);
+  m_dir = dir.string();
+
+  // collect segment files, named <first>-<last>.data and <first>-<last>.index
+  struct FileState
+  {
+    bool hasData = false;
+    bool hasIndex = false;
+  };
+  std::map<std::pair<uint64_t, uint64_t>, FileState> files;
+  for (const auto& item : fs::directory_iterator(dir)) {
+    auto extension = item.path().extension().string();
+    if (extension == TMP_EXTENSION) {
+      fs::remove(item.path());
+      continue;
+    }
+    auto stem = item.path().stem().string();
+    auto pos = stem.find('-');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    std::pair<uint64_t, uint64_t> range;
+    try {
+      range = std::make_pair(std::stoull(stem.substr(0, pos)), std::stoull(stem.substr(pos + 1)));
+    }
+    catch (const std::exception&) {
+      continue;
+    }
+    if (extension == DATA_EXTENSION) {
+      files[range].hasData = true;
+    }
+    else if (extension == INDEX_EXTENSION) {
+      files[range].hasIndex = true;
+    }
+  }
+
+  // drop leftovers of an interrupted compaction: segments covered by a complete merged
+  // segment, and merged segments whose index has not been written
+  auto isCovered = [&files] (const std::pair<uint64_t, uint64_t>& range) {
+    for (const auto& file : files) {
+      if (file.first != range && file.second.hasData && file.second.hasIndex &&
+          file.first.first <= range.first && range.second <= file.first.second) {
+        return true;
+      }
+    }
+    return false;
+  };
+  std::vector<std::pair<uint64_t, uint64_t>> sealed;
+  std::vector<uint64_t> unsealed;
+  for (const auto& file : files) {
+    const auto& range = file.first;
+    bool isComplete = file.second.hasData && file.second.hasIndex;
+    if (isCovered(range) || (!isComplete && range.first != range.second) || !file.second.hasData) {
+      NDN_LOG_DEBUG("Removing stale segment " << range.first << "-" << range.second);
+      fs::remove(makeFileName(range.first, range.second, DATA_EXTENSION));
+      fs::remove(makeFileName(range.first, range.second, INDEX_EXTENSION));
+    }
+    else if (isComplete) {
+      sealed.push_back(range);
+    }
+    else {
+      unsealed.push_back(range.first);
+    }
+  }
+
+  std::sort(sealed.begin(), sealed.end(),
+            [] (const auto& a, const auto& b) { return a.second < b.second; });
+  for (const auto& range : sealed) {
+    m_segments.push_back(std::make_shared<Segment>(range.first, range.second,
+                                                   makeFileName(range.first, range.second, DATA_EXTENSION),
+                                                   makeFileName(range.first, range.second, INDEX_EXTENSION)));
+  }
+
+  // only unsealed segments are replayed; all but the newest are sealed right away
+  std::sort(unsealed.begin(), unsealed.end());
+  uint64_t nextId = m_segments.empty() ? 1 : m_segments.back()->last + 1;
+  for (size_t i = 0; i < unsealed.size(); i++) {
+    if (i + 1 == unsealed.size() && unsealed[i] >= nextId) {
+      nextId = unsealed[i];
+      break;
+    }
+    std::map<Name, IndexEntry> entries;
+    replaySegment(makeFileName(unsealed[i], unsealed[i], DATA_EXTENSION), entries);
+    auto segment = sealSegment(unsealed[i], entries);
+    auto pos = std::find_if(m_segments.begin(), m_segments.end(),
+                            [&segment] (const auto& s) { return s->last > segment->last; });
+    m_segments.insert(pos, segment);
+    nextId = std::max(nextId, unsealed[i] + 1);
+  }
+  openActiveSegment(nextId);
+  NDN_LOG_TRACE("Opened " << m_segments.size() << " sealed segments in " << m_dir);
+  scheduleCompaction();
+}
+
+CtSegment::~CtSegment()
+{
+  if (m_compaction.joinable()) {
+    m_compaction.join();
+  }
+  if (m_activeFd >= 0) {
+    ::fsync(m_activeFd);
+    ::close(m_activeFd);
+  }
+}
+
+std::string
+CtSegment::makeFileName(uint64_t first, uint64_t last, const std::string& extension) const
+{
+  return (fs::path(m_dir) / (std::to_string(first) + "-" + std::to_string(last) + extension)).string();
+}
+
+void
+CtSegment::replaySegment(const std::string& fileName, std::map<Name, IndexEntry>& entries)
+{
+  size_t offset = 0;
+  size_t fileSize = 0;
+  {
+    MappedFile file(fileName);
+    fileSize = file.size();
+    while (offset < fileSize) {
+      bool isOk = false;
+      Block block;
+      std::tie(isOk, block) = Block::fromBuffer(make_span(file.data() + offset, fileSize - offset));
+      if (!isOk) {
+        break;
+      }
+      try {
+        Name name = getBlockName(block);
+        uint32_t flags = block.type() == ndn::tlv::Name ? FLAG_TOMBSTONE : 0;
+        entries[name] = IndexEntry{computeNameDigest(name), offset, static_cast<uint32_t>(block.size()), flags};
+      }
+      catch (const ndn::tlv::Error&) {
+        break;
+      }
+      offset += block.size();
+    }
+  }
+  if (offset < fileSize) {
+    NDN_LOG_WARN("Truncating incomplete tail of " << fileName << " at " << offset);
+    if (::truncate(fileName.data(), static_cast<off_t>(offset)) < 0) {
+      NDN_THROW(std::runtime_error("Cannot truncate " + fileName));
+    }
+  }
+}
+
+void
+CtSegment::openActiveSegment(uint64_t id)
+{
+  auto fileName = makeFileName(id, id, DATA_EXTENSION);
+  m_activeEntries.clear();
+  bool isNew = !fs::exists(fileName);
+  if (!isNew) {
+    replaySegment(fileName, m_activeEntries);
+  }
+  m_activeFd = ::open(fileName.data(), O_RDWR | O_CREAT, 0644);
+  if (m_activeFd < 0) {
+    NDN_THROW(std::runtime_error("Cannot open active segment " + fileName));
+  }
+  // commit only syncs the content of the active segment, not its directory entry
+  if (isNew) {
+    syncParentDirectory(fileName);
+  }
+  m_activeId = id;
+  m_activeSize = fs::file_size(fileName);
+}
+
+std::shared_ptr<const CtSegment::Segment>
+CtSegment::sealSegment(uint64_t id, const std::map<Name, IndexEntry>& entries)
+{
+  std::vector<std::pair<Name, IndexEntry>> indexEntries(entries.begin(), entries.end());
+  auto indexFileName = makeFileName(id, id, INDEX_EXTENSION);
+  writeIndex(indexFileName, std::move(indexEntries));
+  return std::make_shared<Segment>(id, id, makeFileName(id, id, DATA_EXTENSION), indexFileName);
+}
+
+void
+CtSegment::sealActiveSegment()
+{
+  syncFile(m_activeFd, makeFileName(m_activeId, m_activeId, DATA_EXTENSION));
+  ::close(m_activeFd);
+  m_activeFd = -1;
+
+  auto segment = sealSegment(m_activeId, m_activeEntries);
+  {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_segments.push_back(segment);
+  }
+  NDN_LOG_DEBUG("Sealed segment " << m_activeId << " with " << m_activeEntries.size() << " entries");
+  openActiveSegment(m_activeId + 1);
+  scheduleCompaction();
+}
+
+void
+CtSegment::scheduleCompaction()
+{
+  if (m_isCompacting) {
+    return;
+  }
+  // size-ratio policy: starting from the newest segment, take in older segments as long as
+  // each is no larger than the ones taken so far together, so that every merge at least
+  // doubles the merged data and a record is rewritten O(log n) times
+  std::vector<std::shared_ptr<const Segment>> inputs;
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    size_t nInputs = 0;
+    size_t inputSize = 0;
+    for (auto segment = m_segments.rbegin(); segment != m_segments.rend(); ++segment) {
+      if (nInputs > 0 && (*segment)->dataSize() > inputSize) {
+        break;
+      }
+      nInputs++;
+      inputSize += (*segment)->dataSize();
+    }
+    if (nInputs < m_compactionThreshold) {
+      return;
+    }
+    inputs.assign(m_segments.end() - nInputs, m_segments.end());
+  }
+  if (m_compaction.joinable()) {
+    m_compaction.join();
+  }
+  m_isCompacting = true;
+  m_compaction = std::thread([this, inputs = std::move(inputs)] {
+    try {
+      compact(inputs);
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Segment compaction failed: " << e.what());
+    }
+    m_isCompacting = false;
+  });
+}
+
+void
+CtSegment::compact(const std::vector<std::shared_ptr<const Segment>>& inputs)
+{
+  // inputs are immutable, they can be read without holding the lock
+  uint64_t first = inputs.front()->first;
+  uint64_t last = inputs.back()->last;
+  auto dataFileName = makeFileName(first, last, DATA_EXTENSION);
+  auto tmpFileName = dataFileName + TMP_EXTENSION;
+  int fd = ::open(tmpFileName.data(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    NDN_THROW(std::runtime_error("Cannot create " + tmpFileName));
+  }
+
+  bool hasOldest = false;
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    hasOldest = m_segments.front() == inputs.front();
+  }
+
+  // the newest operation on a name wins; if the merge reaches the oldest segment,
+  // tombstones have nothing left to hide and are dropped as well
+  std::unordered_set<Name> seen;
+  std::vector<std::pair<Name, IndexEntry>> entries;
+  uint64_t offset = 0;
+  try {
+    for (auto segment = inputs.rbegin(); segment != inputs.rend(); ++segment) {
+      for (const auto& entry : **segment) {
+        auto wire = (*segment)->read(entry);
+        Name name = readBlockName(wire);
+        if (!seen.insert(name).second || (hasOldest && (entry.flags & FLAG_TOMBSTONE) != 0)) {
+          continue;
+        }
+        writeAll(fd, wire.data(), wire.size(), offset);
+        entries.emplace_back(name, IndexEntry{entry.digest, offset, entry.length, entry.flags});
+        offset += entry.length;
+      }
+    }
+    syncFile(fd, tmpFileName);
+  }
+  catch (const std::exception&) {
+    ::close(fd);
+    fs::remove(tmpFileName);
+    throw;
+  }
+  ::close(fd);
+  fs::rename(tmpFileName, dataFileName);
+  syncParentDirectory(dataFileName);
+  // the index is written last and marks the merged segment as complete
+  auto indexFileName = makeFileName(first, last, INDEX_EXTENSION);
+  writeIndex(indexFileName, std::move(entries));
+  auto merged = std::make_shared<Segment>(first, last, dataFileName, indexFileName);
+
+  {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    // segments sealed in the meantime were appended after the inputs
+    auto pos = std::find(m_segments.begin(), m_segments.end(), inputs.front());
+    pos = m_segments.erase(pos, pos + inputs.size());
+    m_segments.insert(pos, merged);
+  }
+  for (const auto& segment : inputs) {
+    boost::system::error_code ec;
+    fs::remove(segment->dataFileName, ec);
+    fs::remove(segment->indexFileName, ec);
+  }
+  NDN_LOG_DEBUG("Compacted " << inputs.size() << " segments into " << first << "-" << last);
+}
+
+optional<CtSegment::Location>
+CtSegment::findLocation(const Name& name) const
+{
+  auto active = m_activeEntries.find(name);
+  if (active != m_activeEntries.end()) {
+    auto buffer = std::make_shared<Buffer>(active->second.length);
+    ssize_t nRead = ::pread(m_activeFd, buffer->data(), buffer->size(), static_cast<off_t>(active->second.offset));
+    if (nRead != static_cast<ssize_t>(buffer->size())) {
+      NDN_THROW(std::runtime_error("Cannot read active segment " + std::to_string(m_activeId)));
+    }
+    return Location{active->second, Block(buffer)};
+  }
+
+  uint64_t digest = computeNameDigest(name);
+  std::shared_lock<std::shared_mutex> lock(m_mutex);
+  for (auto segment = m_segments.rbegin(); segment != m_segments.rend(); ++segment) {
+    auto range = (*segment)->equalRange(digest);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+      Block block((*segment)->read(*entry));
+      if (getBlockName(block) == name) {
+        return Location{*entry, block};
+      }
+    }
+  }
+  return nullopt;
+}
+
+void
+CtSegment::appendBlock(const Name& name, const Block& block, uint32_t flags)
+{
+  writeAll(m_activeFd, &*block.begin(), block.size(), m_activeSize);
+  m_activeEntries[name] = IndexEntry{computeNameDigest(name), m_activeSize,
+                                     static_cast<uint32_t>(block.size()), flags};
+  m_activeSize += block.size();
+  if (m_activeSize >= m_segmentSizeLimit) {
+    sealActiveSegment();
+  }
+}
+
+void
+CtSegment::addData(Data data)
+{
+  const Name& name = data.getName();
+  auto location = findLocation(name);
+  if (location && location->block.type() == ndn::tlv::Data) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " already exists"));
+  }
+  appendBlock(name, data.wireEncode(), 0);
+}
+
+std::shared_ptr<const Data>
+CtSegment::findData(const Name& name)
+{
+  auto location = findLocation(name);
+  if (!location || location->block.type() != ndn::tlv::Data) {
+    return nullptr;
+  }
+  return std::make_shared<const Data>(location->block);
+}
+
+std::shared_ptr<const Data>
+CtSegment::findLatestData(const Name& prefix)
+{
+  auto location = findLastLocation(prefix, nullopt);
+  if (!location) {
+    return nullptr;
+  }
+  return std::make_shared<const Data>(location->block);
+}
+
+optional<CtSegment::Location>
+CtSegment::findLastLocation(const Name& prefix, optional<Name> limit) const
+{
+  // take the greatest name under the prefix across the active and sealed segments; if the
+  // newest operation on it is a tombstone, retry below it
+  while (true) {
+    optional<Name> candidate;
+    auto active = limit ? m_activeEntries.lower_bound(*limit) :
+                  prefix.empty() ? m_activeEntries.end() : m_activeEntries.lower_bound(prefix.getSuccessor());
+    if (active != m_activeEntries.begin() && prefix.isPrefixOf(std::prev(active)->first)) {
+      candidate = std::prev(active)->first;
+    }
+    {
+      std::shared_lock<std::shared_mutex> lock(m_mutex);
+      for (const auto& segment : m_segments) {
+        auto entry = segment->findLastBefore(prefix, limit);
+        if (entry != nullptr) {
+          Name name = readBlockName(segment->read(*entry));
+          if (!candidate || *candidate < name) {
+            candidate = std::move(name);
+          }
+        }
+      }
+    }
+    if (!candidate) {
+      return nullopt;
+    }
+    auto location = findLocation(*candidate);
+    if (location && location->block.type() == ndn::tlv::Data) {
+      return location;
+    }
+    limit = std::move(candidate);
+  }
+}
+
+void
+CtSegment::deleteData(const Name& name)
+{
+  auto location = findLocation(name);
+  if (!location || location->block.type() != ndn::tlv::Data) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
+  }
+  appendBlock(name, name.wireEncode(), FLAG_TOMBSTONE);
+}
+
+void
+CtSegment::commit()
+{
+  if (::fdatasync(m_activeFd) < 0) {
+    NDN_THROW(std::runtime_error("Cannot sync active segment: " + std::string(std::strerror(errno))));
+  }
+}
+
+void
+CtSegment::visitNames(const Name& prefix, const NameVisitor& visitor)
+{
+  // as in lookups, the newest operation on a name hides the older ones
+  std::unordered_set<Name> seen;
+  std::vector<Name> names;
+  for (const auto& active : m_activeEntries) {
+    seen.insert(active.first);
+    if ((active.second.flags & FLAG_TOMBSTONE) == 0 && prefix.isPrefixOf(active.first)) {
+      names.push_back(active.first);
+    }
+  }
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (auto segment = m_segments.rbegin(); segment != m_segments.rend(); ++segment) {
+      for (const auto& entry : **segment) {
+        Name name = readBlockName((*segment)->read(entry));
+        if (seen.insert(name).second && (entry.flags & FLAG_TOMBSTONE) == 0 && prefix.isPrefixOf(name)) {
+          names.push_back(std::move(name));
+        }
+      }
+    }
+  }
+
+  // the visitor runs without the lock and after the active entries are read, so it may
+  // write to the storage, e.g., seal the active segment
+  for (const auto& name : names) {
+    visitor(name);
+  }
+}
+
+std::vector<Name>
+CtSegment::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  std::vector<Name> names;
+  if (limit == 0) {
+    return names;
+  }
+  bool isAfter = after && *after >= prefix;
+  const Name& start = isAfter ? *after : prefix;
+  auto active = isAfter ? m_activeEntries.upper_bound(start) : m_activeEntries.lower_bound(start);
+
+  // merge the sorted names of the active segment and of every sealed one, newest first, so
+  // that the first source holding a name has its newest operation
+  struct Cursor
+  {
+    const Segment* segment;
+    uint32_t position;
+    Name name;
+  };
+  std::shared_lock<std::shared_mutex> lock(m_mutex);
+  std::vector<Cursor> cursors;
+  for (auto segment = m_segments.rbegin(); segment != m_segments.rend(); ++segment) {
+    uint32_t position = (*segment)->seek(start, isAfter);
+    if (position < (*segment)->size()) {
+      cursors.push_back({segment->get(), position, (*segment)->nameAt(position)});
+    }
+  }
+
+  while (names.size() < limit) {
+    const Name* next = active != m_activeEntries.end() ? &active->first : nullptr;
+    for (const auto& cursor : cursors) {
+      if (cursor.position < cursor.segment->size() && (next == nullptr || cursor.name < *next)) {
+        next = &cursor.name;
+      }
+    }
+    if (next == nullptr || !prefix.isPrefixOf(*next)) {
+      break;
+    }
+    Name name = *next;
+    optional<bool> isTombstone;
+    if (active != m_activeEntries.end() && active->first == name) {
+      isTombstone = (active->second.flags & FLAG_TOMBSTONE) != 0;
+      ++active;
+    }
+    for (auto& cursor : cursors) {
+      if (cursor.position == cursor.segment->size() || cursor.name != name) {
+        continue;
+      }
+      if (!isTombstone) {
+        isTombstone = (cursor.segment->entryAt(cursor.position).flags & FLAG_TOMBSTONE) != 0;
+      }
+      if (++cursor.position < cursor.segment->size()) {
+        cursor.name = cursor.segment->nameAt(cursor.position);
+      }
+    }
+    if (!*isTombstone) {
+      names.push_back(std::move(name));
+    }
+  }
+  return names;
+}
+
+optional<Name>
+CtSegment::findPrecedingName(const Name& prefix, const Name& name)
+{
+  if (name <= prefix) {
+    return nullopt;
+  }
+  // a name past the prefix range bounds nothing in it
+  auto location = findLastLocation(prefix, prefix.isPrefixOf(name) ? optional<Name>(name) : nullopt);
+  if (!location) {
+    return nullopt;
+  }
+  return getBlockName(location->block);
+}
+
+} // namespace ct
+} // namespace ndnrevoke
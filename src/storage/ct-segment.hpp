@@ -0,0 +1,147 @@
+#ifndef NDNREVOKE_CT_SEGMENT_HPP
+#define NDNREVOKE_CT_SEGMENT_HPP
+
+#include "ct-storage.hpp"
+
+#include <atomic>
+#include <shared_mutex>
+#include <thread>
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Log-structured CT storage made of immutable segment files.
+ *
+ * Records are appended as TLV blocks to the active segment: a Data block stores a record
+ * and a Name block is a tombstone left by deleteData.  Once the active segment grows past
+ * SEGMENT_SIZE_LIMIT it is sealed: an index of fixed-width entries sorted by name digest
+ * is written next to it, together with the order of the entries by name, and both files
+ * are memory-mapped.  A lookup is a binary search in each mapped index (newest segment
+ * first) followed by a read from the mapped data; prefix lookups and listings search the
+ * name order, and a listing merges the name orders of the segments from where it starts.
+ *
+ * On startup sealed segments are mapped as they are, only the active segment is replayed.
+ * A background thread merges the newest sealed segments into one once at least
+ * COMPACTION_THRESHOLD of them are each no larger than the newer ones together, dropping
+ * overwritten records, and tombstones if the merge reaches the oldest segment.
+ *
+ * If @p path is empty, segments are kept in $HOME/.ndnrevoke/<ct-name>-segments.
+ */
+class CtSegment : public CtStorage
+{
+public:
+  CtSegment(const Name& ctName = Name(), const std::string& path = "");
+  const static std::string STORAGE_TYPE;
+
+  ~CtSegment() override;
+
+public:
+  void
+  addData(Data data) override;
+
+  std::shared_ptr<const Data>
+  findData(const Name& name) override;
+
+  std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) override;
+
+  void
+  deleteData(const Name& name) override;
+
+  void
+  visitNames(const Name& prefix, const NameVisitor& visitor) override;
+
+  std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit) override;
+
+  optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name) override;
+
+  void
+  commit() override;
+
+public:
+  static const size_t SEGMENT_SIZE_LIMIT;
+  static const size_t COMPACTION_THRESHOLD;
+
+  /**
+   * @brief Fixed-width entry of a segment index, as laid out on disk.
+   */
+  struct IndexEntry
+  {
+    uint64_t digest;
+    uint64_t offset;
+    uint32_t length;
+    uint32_t flags;
+  };
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  class Segment;
+
+  /**
+   * @brief The latest operation on a name, either a Data or a tombstone Name block.
+   */
+  struct Location
+  {
+    IndexEntry entry;
+    Block block;
+  };
+
+  optional<Location>
+  findLocation(const Name& name) const;
+
+  /**
+   * @return the newest operation on the last name under @p prefix before @p limit (or the
+   *         end of the prefix range) that still holds a Data, or nullopt
+   */
+  optional<Location>
+  findLastLocation(const Name& prefix, optional<Name> limit) const;
+
+  void
+  appendBlock(const Name& name, const Block& block, uint32_t flags);
+
+  void
+  openActiveSegment(uint64_t id);
+
+  void
+  replaySegment(const std::string& fileName, std::map<Name, IndexEntry>& entries);
+
+  std::shared_ptr<const Segment>
+  sealSegment(uint64_t id, const std::map<Name, IndexEntry>& entries);
+
+  void
+  sealActiveSegment();
+
+  void
+  scheduleCompaction();
+
+  void
+  compact(const std::vector<std::shared_ptr<const Segment>>& inputs);
+
+  std::string
+  makeFileName(uint64_t first, uint64_t last, const std::string& extension) const;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::string m_dir;
+
+  // sealed segments, oldest first; guarded by m_mutex
+  std::vector<std::shared_ptr<const Segment>> m_segments;
+  mutable std::shared_mutex m_mutex;
+
+  // active segment, only accessed from the caller's thread
+  uint64_t m_activeId = 0;
+  int m_activeFd = -1;
+  uint64_t m_activeSize = 0;
+  std::map<Name, IndexEntry> m_activeEntries;
+
+  size_t m_segmentSizeLimit = SEGMENT_SIZE_LIMIT;
+  size_t m_compactionThreshold = COMPACTION_THRESHOLD;
+  std::thread m_compaction;
+  std::atomic<bool> m_isCompacting{false};
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_CT_SEGMENT_HPP
@@ -0,0 +1,383 @@
+#include "ct-sqlite.hpp"
+
+#include <sqlite3.h>
+
+#include <boost/filesystem.hpp>
+
+namespace ndnrevoke {
+namespace ct {
+
+NDN_LOG_INIT(ndnrevoke.storage.sqlite);
+
+const std::string CtSqlite::STORAGE_TYPE = "ct-storage-sqlite";
+NDNREVOKE_REGISTER_CT_STORAGE(CtSqlite);
+
+static const std::string INITIALIZATION = R"_DBTEXT_(
+PRAGMA journal_mode=WAL;
+PRAGMA synchronous=FULL;
+CREATE TABLE IF NOT EXISTS
+  CtRecords(
+    id INTEGER PRIMARY KEY,
+    name BLOB NOT NULL,
+    sort_key BLOB NOT NULL,
+    data BLOB NOT NULL
+  );
+CREATE UNIQUE INDEX IF NOT EXISTS
+  CtRecordsSortKeyIndex ON CtRecords(sort_key);
+)_DBTEXT_";
+
+namespace {
+
+/**
+ * @brief Resets a reusable prepared statement when leaving the scope.
+ */
+class StatementGuard : boost::noncopyable
+{
+public:
+  explicit
+  StatementGuard(sqlite3_stmt* statement)
+    : m_statement(statement)
+  {
+  }
+
+  ~StatementGuard()
+  {
+    sqlite3_reset(m_statement);
+    sqlite3_clear_bindings(m_statement);
+  }
+
+private:
+  sqlite3_stmt* m_statement;
+};
+
+int
+bindBlock(sqlite3_stmt* statement, int index, const Block& block)
+{
+  // the block outlives the statement execution, no need for SQLite to copy it
+  return sqlite3_bind_blob(statement, index, &*block.begin(), static_cast<int>(block.size()), SQLITE_STATIC);
+}
+
+int
+bindBuffer(sqlite3_stmt* statement, int index, const Buffer& buffer)
+{
+  // an empty blob must not be bound as NULL, which compares false with everything
+  if (buffer.empty()) {
+    return sqlite3_bind_zeroblob(statement, index, 0);
+  }
+  return sqlite3_bind_blob(statement, index, buffer.data(), static_cast<int>(buffer.size()), SQLITE_STATIC);
+}
+
+/**
+ * @brief Make the smallest key that is greater than every key starting with @p key.
+ */
+Buffer
+makeUpperBound(const Buffer& key)
+{
+  Buffer bound(key);
+  while (!bound.empty() && bound.back() == 0xFF) {
+    bound.pop_back();
+  }
+  if (bound.empty()) {
+    // no component has both TLV-TYPE and TLV-LENGTH equal to 0xFFFFFFFF
+    bound.resize(8);
+    std::fill(bound.begin(), bound.end(), 0xFF);
+    return bound;
+  }
+  bound.back()++;
+  return bound;
+}
+
+std::shared_ptr<const Data>
+readData(sqlite3_stmt* statement, int column)
+{
+  auto wire = static_cast<const uint8_t*>(sqlite3_column_blob(statement, column));
+  auto size = static_cast<size_t>(sqlite3_column_bytes(statement, column));
+  return std::make_shared<const Data>(Block(make_span(wire, size)));
+}
+
+} // namespace
+
+CtSqlite::CtSqlite(const Name& ctName, const std::string& path)
+  : CtStorage()
+{
+  // determine the path of sqlite db
+  boost::filesystem::path dbDir;
+  if (!path.empty()) {
+    dbDir = boost::filesystem::path(path);
+    if (dbDir.has_parent_path()) {
+      boost::filesystem::create_directories(dbDir.parent_path());
+    }
+  }
+  else {
+    std::string dbName = ctName.toUri();
+    std::replace(dbName.begin(), dbName.end(), '/', '_');
+    dbName += ".db";
+    if (getenv("HOME") != nullptr) {
+      dbDir = boost::filesystem::path(getenv("HOME")) / ".ndnrevoke";
+    }
+    else {
+      dbDir = boost::filesystem::current_path() / ".ndnrevoke";
+    }
+    boost::filesystem::create_directories(dbDir);
+    dbDir /= dbName;
+  }
+
+  // open and initialize database
+  int result = sqlite3_open_v2(dbDir.c_str(), &m_database,
+                               SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+#ifdef NDN_CXX_DISABLE_SQLITE3_FS_LOCKING
+                               "unix-dotfile"
+#else
+                               nullptr
+#endif
+                               );
+  if (result != SQLITE_OK) {
+    sqlite3_close(m_database);
+    NDN_THROW(std::runtime_error("CtSqlite DB cannot be opened/created: " + dbDir.string()));
+  }
+
+  char* errorMessage = nullptr;
+  result = sqlite3_exec(m_database, INITIALIZATION.data(), nullptr, nullptr, &errorMessage);
+  if (result != SQLITE_OK) {
+    std::string reason = errorMessage != nullptr ? errorMessage : sqlite3_errmsg(m_database);
+    sqlite3_free(errorMessage);
+    sqlite3_close(m_database);
+    NDN_THROW(std::runtime_error("CtSqlite DB cannot be initialized: " + reason));
+  }
+
+  try {
+    m_insertStatement = prepareStatement("INSERT INTO CtRecords (name, sort_key, data) VALUES (?, ?, ?)");
+    m_selectStatement = prepareStatement("SELECT data FROM CtRecords WHERE sort_key = ?");
+    m_selectLatestStatement = prepareStatement("SELECT data FROM CtRecords WHERE sort_key >= ? AND sort_key < ? "
+                                               "ORDER BY sort_key DESC LIMIT 1");
+    m_deleteStatement = prepareStatement("DELETE FROM CtRecords WHERE sort_key = ?");
+    m_scanStatement = prepareStatement("SELECT name FROM CtRecords WHERE sort_key >= ? AND sort_key < ? "
+                                       "ORDER BY sort_key");
+    m_listStatement = prepareStatement("SELECT name FROM CtRecords WHERE sort_key >= ? AND sort_key < ? "
+                                       "ORDER BY sort_key LIMIT ?");
+    m_precedingStatement = prepareStatement("SELECT name FROM CtRecords WHERE sort_key >= ? AND sort_key < ? "
+                                            "ORDER BY sort_key DESC LIMIT 1");
+  }
+  catch (const std::exception&) {
+    sqlite3_finalize(m_insertStatement);
+    sqlite3_finalize(m_selectStatement);
+    sqlite3_finalize(m_selectLatestStatement);
+    sqlite3_finalize(m_deleteStatement);
+    sqlite3_finalize(m_scanStatement);
+    sqlite3_finalize(m_listStatement);
+    sqlite3_finalize(m_precedingStatement);
+    sqlite3_close(m_database);
+    throw;
+  }
+  NDN_LOG_TRACE("Opened CT database " << dbDir.string());
+}
+
+CtSqlite::~CtSqlite()
+{
+  try {
+    commit();
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("CtSqlite cannot commit on close: " << e.what());
+  }
+  sqlite3_finalize(m_insertStatement);
+  sqlite3_finalize(m_selectStatement);
+  sqlite3_finalize(m_selectLatestStatement);
+  sqlite3_finalize(m_deleteStatement);
+  sqlite3_finalize(m_scanStatement);
+  sqlite3_finalize(m_listStatement);
+  sqlite3_finalize(m_precedingStatement);
+  sqlite3_close(m_database);
+}
+
+sqlite3_stmt*
+CtSqlite::prepareStatement(const std::string& sql)
+{
+  sqlite3_stmt* statement = nullptr;
+  int result = sqlite3_prepare_v2(m_database, sql.data(), static_cast<int>(sql.size()), &statement, nullptr);
+  if (result != SQLITE_OK) {
+    NDN_THROW(std::runtime_error("CtSqlite cannot prepare statement: " + std::string(sqlite3_errmsg(m_database))));
+  }
+  return statement;
+}
+
+void
+CtSqlite::execute(const char* sql)
+{
+  char* errorMessage = nullptr;
+  if (sqlite3_exec(m_database, sql, nullptr, nullptr, &errorMessage) != SQLITE_OK) {
+    std::string reason = errorMessage != nullptr ? errorMessage : sqlite3_errmsg(m_database);
+    sqlite3_free(errorMessage);
+    NDN_THROW(std::runtime_error("CtSqlite cannot execute " + std::string(sql) + ": " + reason));
+  }
+}
+
+void
+CtSqlite::beginTransaction()
+{
+  if (!m_isInTransaction) {
+    execute("BEGIN");
+    m_isInTransaction = true;
+  }
+}
+
+void
+CtSqlite::commit()
+{
+  if (!m_isInTransaction) {
+    return;
+  }
+  try {
+    execute("COMMIT");
+  }
+  catch (const std::exception&) {
+    // a failed commit may have rolled the transaction back
+    m_isInTransaction = sqlite3_get_autocommit(m_database) == 0;
+    throw;
+  }
+  m_isInTransaction = false;
+}
+
+void
+CtSqlite::addData(Data data)
+{
+  const Name& name = data.getName();
+  auto sortKey = encodeSortKey(name);
+  beginTransaction();
+  StatementGuard guard(m_insertStatement);
+  bindBlock(m_insertStatement, 1, name.wireEncode());
+  bindBuffer(m_insertStatement, 2, sortKey);
+  bindBlock(m_insertStatement, 3, data.wireEncode());
+  int result = sqlite3_step(m_insertStatement);
+  if (result == SQLITE_CONSTRAINT) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " already exists"));
+  }
+  if (result != SQLITE_DONE) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " cannot be stored: " +
+                                 sqlite3_errmsg(m_database)));
+  }
+}
+
+std::shared_ptr<const Data>
+CtSqlite::findData(const Name& name)
+{
+  auto sortKey = encodeSortKey(name);
+  StatementGuard guard(m_selectStatement);
+  bindBuffer(m_selectStatement, 1, sortKey);
+  int result = sqlite3_step(m_selectStatement);
+  if (result == SQLITE_DONE) {
+    return nullptr;
+  }
+  if (result != SQLITE_ROW) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " cannot be read: " +
+                                 sqlite3_errmsg(m_database)));
+  }
+  return readData(m_selectStatement, 0);
+}
+
+std::shared_ptr<const Data>
+CtSqlite::findLatestData(const Name& prefix)
+{
+  auto lower = encodeSortKey(prefix);
+  auto upper = makeUpperBound(lower);
+  StatementGuard guard(m_selectLatestStatement);
+  bindBuffer(m_selectLatestStatement, 1, lower);
+  bindBuffer(m_selectLatestStatement, 2, upper);
+  int result = sqlite3_step(m_selectLatestStatement);
+  if (result == SQLITE_DONE) {
+    return nullptr;
+  }
+  if (result != SQLITE_ROW) {
+    NDN_THROW(std::runtime_error("Data under " + prefix.toUri() + " cannot be read: " +
+                                 sqlite3_errmsg(m_database)));
+  }
+  return readData(m_selectLatestStatement, 0);
+}
+
+void
+CtSqlite::deleteData(const Name& name)
+{
+  auto sortKey = encodeSortKey(name);
+  beginTransaction();
+  StatementGuard guard(m_deleteStatement);
+  bindBuffer(m_deleteStatement, 1, sortKey);
+  if (sqlite3_step(m_deleteStatement) != SQLITE_DONE) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " cannot be deleted: " +
+                                 sqlite3_errmsg(m_database)));
+  }
+  if (sqlite3_changes(m_database) == 0) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
+  }
+}
+
+void
+CtSqlite::visitNames(const Name& prefix, const NameVisitor& visitor)
+{
+  auto lower = encodeSortKey(prefix);
+  auto upper = makeUpperBound(lower);
+  StatementGuard guard(m_scanStatement);
+  bindBuffer(m_scanStatement, 1, lower);
+  bindBuffer(m_scanStatement, 2, upper);
+  int result;
+  while ((result = sqlite3_step(m_scanStatement)) == SQLITE_ROW) {
+    auto wire = static_cast<const uint8_t*>(sqlite3_column_blob(m_scanStatement, 0));
+    auto size = static_cast<size_t>(sqlite3_column_bytes(m_scanStatement, 0));
+    visitor(Name(Block(make_span(wire, size))));
+  }
+  if (result != SQLITE_DONE) {
+    NDN_THROW(std::runtime_error("CtSqlite cannot scan records: " + std::string(sqlite3_errmsg(m_database))));
+  }
+}
+
+std::vector<Name>
+CtSqlite::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  auto prefixKey = encodeSortKey(prefix);
+  auto upper = makeUpperBound(prefixKey);
+  auto lower = prefixKey;
+  if (after) {
+    // the smallest key greater than the key of after
+    auto afterKey = encodeSortKey(*after);
+    afterKey.push_back(0);
+    lower = std::max(lower, afterKey);
+  }
+  StatementGuard guard(m_listStatement);
+  bindBuffer(m_listStatement, 1, lower);
+  bindBuffer(m_listStatement, 2, upper);
+  sqlite3_bind_int64(m_listStatement, 3, static_cast<sqlite3_int64>(std::min<size_t>(limit, INT64_MAX)));
+  std::vector<Name> names;
+  int result;
+  while ((result = sqlite3_step(m_listStatement)) == SQLITE_ROW) {
+    auto wire = static_cast<const uint8_t*>(sqlite3_column_blob(m_listStatement, 0));
+    auto size = static_cast<size_t>(sqlite3_column_bytes(m_listStatement, 0));
+    names.emplace_back(Block(make_span(wire, size)));
+  }
+  if (result != SQLITE_DONE) {
+    NDN_THROW(std::runtime_error("CtSqlite cannot list records: " + std::string(sqlite3_errmsg(m_database))));
+  }
+  return names;
+}
+
+optional<Name>
+CtSqlite::findPrecedingName(const Name& prefix, const Name& name)
+{
+  auto lower = encodeSortKey(prefix);
+  auto upper = encodeSortKey(name);
+  StatementGuard guard(m_precedingStatement);
+  bindBuffer(m_precedingStatement, 1, lower);
+  bindBuffer(m_precedingStatement, 2, upper);
+  int result = sqlite3_step(m_precedingStatement);
+  if (result == SQLITE_DONE) {
+    return nullopt;
+  }
+  if (result != SQLITE_ROW) {
+    NDN_THROW(std::runtime_error("Names before " + name.toUri() + " cannot be read: " +
+                                 sqlite3_errmsg(m_database)));
+  }
+  auto wire = static_cast<const uint8_t*>(sqlite3_column_blob(m_precedingStatement, 0));
+  auto size = static_cast<size_t>(sqlite3_column_bytes(m_precedingStatement, 0));
+  return Name(Block(make_span(wire, size)));
+}
+
+} // namespace ct
+} // namespace ndnrevoke
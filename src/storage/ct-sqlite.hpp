@@ -0,0 +1,84 @@
+#ifndef NDNREVOKE_CT_SQLITE_HPP
+#define NDNREVOKE_CT_SQLITE_HPP
+
+#include "ct-storage.hpp"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Persistent CT storage backed by SQLite3.
+ *
+ * Records are kept in a single table indexed by CtStorage::encodeSortKey of the Data name,
+ * so prefix lookups are range scans over the index.  The database runs in WAL journaling
+ * mode, and every statement is prepared once when the storage is opened and reused afterwards.
+ * Changes are grouped in a transaction that commit finishes, and with synchronous=FULL
+ * a finished transaction survives a power loss, so a group commit costs one sync.
+ *
+ * If @p path is empty, the database is created at $HOME/.ndnrevoke/<ct-name>.db.
+ */
+class CtSqlite : public CtStorage
+{
+public:
+  CtSqlite(const Name& ctName = Name(), const std::string& path = "");
+  const static std::string STORAGE_TYPE;
+
+  ~CtSqlite() override;
+
+public:
+  void
+  addData(Data data) override;
+
+  std::shared_ptr<const Data>
+  findData(const Name& name) override;
+
+  std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) override;
+
+  void
+  deleteData(const Name& name) override;
+
+  void
+  visitNames(const Name& prefix, const NameVisitor& visitor) override;
+
+  std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit) override;
+
+  optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name) override;
+
+  void
+  commit() override;
+
+private:
+  sqlite3_stmt*
+  prepareStatement(const std::string& sql);
+
+  void
+  execute(const char* sql);
+
+  /**
+   * @brief Open the transaction holding the changes until the next commit, if not yet open.
+   */
+  void
+  beginTransaction();
+
+private:
+  sqlite3* m_database = nullptr;
+  sqlite3_stmt* m_insertStatement = nullptr;
+  sqlite3_stmt* m_selectStatement = nullptr;
+  sqlite3_stmt* m_selectLatestStatement = nullptr;
+  sqlite3_stmt* m_deleteStatement = nullptr;
+  sqlite3_stmt* m_scanStatement = nullptr;
+  sqlite3_stmt* m_listStatement = nullptr;
+  sqlite3_stmt* m_precedingStatement = nullptr;
+  bool m_isInTransaction = false;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_CT_SQLITE_HPP
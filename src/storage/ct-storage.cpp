@@ -1,16 +1,155 @@
 #include "ct-storage.hpp"
 
+#include <cstring>
+#include <set>
+
 namespace ndnrevoke {
 namespace ct {
 
 std::unique_ptr<CtStorage>
-CtStorage::createCtStorage(const std::string& ctStorageType, const Name& ctName, const std::string& path)
+CtStorage::createCtStorage(const std::string& ctStorageType, const Name& ctName, const std::string& path,
+                           const Parameters& parameters)
 {
+  auto separator = ctStorageType.find(':');
+  if (separator != std::string::npos) {
+    CtStorageDecoratorFactory& factory = getDecoratorFactory();
+    auto i = factory.find(ctStorageType.substr(0, separator));
+    if (i == factory.end()) {
+      return nullptr;
+    }
+    auto inner = createCtStorage(ctStorageType.substr(separator + 1), ctName, path, parameters);
+    return inner == nullptr ? nullptr : i->second(std::move(inner), ctName, path, parameters);
+  }
+
   CtStorageFactory& factory = getFactory();
   auto i = factory.find(ctStorageType);
   return i == factory.end() ? nullptr : i->second(ctName, path);
 }
 
+Data
+CtStorage::getData(const Name& name)
+{
+  auto data = findData(name);
+  if (data == nullptr) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
+  }
+  return *data;
+}
+
+std::vector<Name>
+CtStorage::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  // the smallest names seen so far, as the visiting order is backend specific
+  std::set<Name> names;
+  if (limit == 0) {
+    return {};
+  }
+  visitNames(prefix, [&] (const Name& name) {
+    if (after && name <= *after) {
+      return;
+    }
+    if (names.size() < limit) {
+      names.insert(name);
+    }
+    else if (name < *names.rbegin()) {
+      names.erase(std::prev(names.end()));
+      names.insert(name);
+    }
+  });
+  return {names.begin(), names.end()};
+}
+
+optional<Name>
+CtStorage::findPrecedingName(const Name& prefix, const Name& name)
+{
+  optional<Name> preceding;
+  visitNames(prefix, [&] (const Name& stored) {
+    if (stored < name && (!preceding || *preceding < stored)) {
+      preceding = stored;
+    }
+  });
+  return preceding;
+}
+
+uint64_t
+CtStorage::computeNameDigest(const Name& name)
+{
+  // MurmurHash64A over the wire encoding of the name
+  const Block& wire = name.wireEncode();
+  const uint8_t* data = &*wire.begin();
+  const size_t len = wire.size();
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+
+  uint64_t h = len * m;
+  const uint8_t* end = data + (len / 8) * 8;
+  for (; data != end; data += 8) {
+    uint64_t k;
+    std::memcpy(&k, data, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  switch (len & 7) {
+    case 7: h ^= uint64_t(data[6]) << 48; // fall through
+    case 6: h ^= uint64_t(data[5]) << 40; // fall through
+    case 5: h ^= uint64_t(data[4]) << 32; // fall through
+    case 4: h ^= uint64_t(data[3]) << 24; // fall through
+    case 3: h ^= uint64_t(data[2]) << 16; // fall through
+    case 2: h ^= uint64_t(data[1]) << 8; // fall through
+    case 1: h ^= uint64_t(data[0]);
+            h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+Buffer
+CtStorage::encodeSortKey(const Name& name)
+{
+  Buffer key;
+  key.reserve(name.wireEncode().value_size() + 6 * name.size());
+  auto appendUint32 = [&key] (uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      key.push_back(static_cast<uint8_t>(value >> shift));
+    }
+  };
+  for (const auto& component : name) {
+    appendUint32(component.type());
+    appendUint32(static_cast<uint32_t>(component.value_size()));
+    key.insert(key.end(), component.value(), component.value() + component.value_size());
+  }
+  return key;
+}
+
+Name
+CtStorage::decodeSortKey(span<const uint8_t> key)
+{
+  auto readUint32 = [] (const uint8_t* pos) {
+    return (uint32_t(pos[0]) << 24) | (uint32_t(pos[1]) << 16) | (uint32_t(pos[2]) << 8) | uint32_t(pos[3]);
+  };
+  Name name;
+  size_t offset = 0;
+  while (offset < key.size()) {
+    if (key.size() - offset < 8) {
+      NDN_THROW(std::runtime_error("Truncated sort key"));
+    }
+    uint32_t type = readUint32(key.data() + offset);
+    uint32_t length = readUint32(key.data() + offset + 4);
+    offset += 8;
+    if (key.size() - offset < length) {
+      NDN_THROW(std::runtime_error("Truncated sort key"));
+    }
+    name.append(Name::Component(type, key.subspan(offset, length)));
+    offset += length;
+  }
+  return name;
+}
+
 CtStorage::CtStorageFactory&
 CtStorage::getFactory()
 {
@@ -18,5 +157,12 @@ CtStorage::getFactory()
   return factory;
 }
 
+CtStorage::CtStorageDecoratorFactory&
+CtStorage::getDecoratorFactory()
+{
+  static CtStorage::CtStorageDecoratorFactory factory;
+  return factory;
+}
+
 } // namespace ct
 } // namespace ndnrevoke
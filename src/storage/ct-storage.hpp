@@ -10,17 +10,117 @@ class CtStorage : boost::noncopyable
 {
 public: 
 
+  /**
+   * @brief Store @p data, taking ownership of it.
+   * @throw std::runtime_error a Data with the same name is already stored
+   */
   virtual void
-  addData(const Data& data) = 0;
+  addData(Data data) = 0;
 
-  virtual Data
-  getData(const Name& name) = 0;
+  /**
+   * @brief Look up the Data named @p name.
+   *
+   * The returned Data is immutable and its wire encoding is cached, so it can be put
+   * to a face as is.  Backends that keep records in memory share them across lookups.
+   * @return the Data, or nullptr if no such Data is stored
+   */
+  virtual std::shared_ptr<const Data>
+  findData(const Name& name) = 0;
+
+  /**
+   * @brief Get a copy of the Data named @p name.
+   * @throw std::runtime_error no such Data is stored
+   */
+  Data
+  getData(const Name& name);
+
+  /**
+   * @brief Look up the newest Data whose name starts with @p prefix.
+   *
+   * The newest Data is the last one under @p prefix in NDN canonical order (e.g., the
+   * highest version), which is what an Interest with CanBePrefix expects.
+   * @return the Data, or nullptr if no Data is stored under @p prefix
+   */
+  virtual std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) = 0;
 
   virtual void
   deleteData(const Name& name) = 0;
 
+  /**
+   * @brief Make the changes applied so far durable.
+   *
+   * Backends may defer the persistence of addData and deleteData until commit, so that
+   * a batch of changes shares one sync.  The default implementation does nothing.
+   * @throw std::runtime_error the changes cannot be persisted
+   */
+  virtual void
+  commit()
+  {
+  }
+
+  using NameVisitor = std::function<void(const Name&)>;
+
+  /**
+   * @brief Invoke @p visitor on the name of every stored Data under @p prefix.
+   */
+  virtual void
+  visitNames(const Name& prefix, const NameVisitor& visitor) = 0;
+
+  /**
+   * @brief List the names of the stored Data under @p prefix, in NDN canonical order.
+   *
+   * Unlike visitNames, a listing is bounded: it returns at most @p limit names that come
+   * after @p after, so a scan can be resumed from the last name of the previous listing.
+   * The default implementation visits every name under @p prefix but only keeps
+   * @p limit of them; backends with an ordered index seek to @p after instead.
+   */
+  virtual std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit);
+
+  /**
+   * @brief Look up the last stored name under @p prefix that comes before @p name.
+   *
+   * Together with listNames, this finds the stored names adjacent to a name that is not
+   * stored.  The default implementation visits every name under @p prefix.
+   * @return the name, or nullopt if no stored name under @p prefix precedes @p name
+   */
+  virtual optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name);
+
+public: // helpers shared by backends
+  /**
+   * @brief Compute a 64-bit digest over the TLV encoding of @p name.
+   *
+   * The digest is stable across processes, so it can be persisted in on-disk indexes,
+   * but it is not collision resistant: callers must confirm a match by comparing names.
+   */
+  static uint64_t
+  computeNameDigest(const Name& name);
+
+  /**
+   * @brief Encode @p name into a key whose bytewise order is the NDN canonical order.
+   *
+   * Each component is encoded as a 4-octet big-endian TLV-TYPE, a 4-octet big-endian
+   * TLV-LENGTH and the TLV-VALUE, so that the keys of all names under a prefix start
+   * with the key of that prefix.
+   */
+  static Buffer
+  encodeSortKey(const Name& name);
+
+  /**
+   * @brief Decode a key made by encodeSortKey.
+   * @throw std::runtime_error @p key is malformed
+   */
+  static Name
+  decodeSortKey(span<const uint8_t> key);
 
 public: // factory
+  /**
+   * @brief Settings from the CT configuration, handed to the decorators that use them.
+   */
+  using Parameters = std::map<std::string, std::string>;
+
   template<class CtStorageType>
   static void
   registerCtStorage(const std::string& ctStorageType = CtStorageType::STORAGE_TYPE)
@@ -31,8 +131,28 @@ public: // factory
     };
   }
 
+  /**
+   * @brief Register a storage that wraps another one, created as "<decorator-type>:<inner-type>".
+   */
+  template<class CtStorageDecoratorType>
+  static void
+  registerCtStorageDecorator(const std::string& ctStorageType = CtStorageDecoratorType::STORAGE_TYPE)
+  {
+    CtStorageDecoratorFactory& factory = getDecoratorFactory();
+    factory[ctStorageType] = [] (std::unique_ptr<CtStorage> inner, const Name& ctName, const std::string& path,
+                                 const Parameters& parameters) {
+      return std::make_unique<CtStorageDecoratorType>(std::move(inner), ctName, path, parameters);
+    };
+  }
+
+  /**
+   * @return the storage, or nullptr if @p ctStorageType, or the type of a decorated storage,
+   *         is not registered
+   * @throw std::runtime_error a decorator rejects its entry in @p parameters
+   */
   static std::unique_ptr<CtStorage>
-  createCtStorage(const std::string& ctStorageType, const Name& ctName, const std::string& path);
+  createCtStorage(const std::string& ctStorageType, const Name& ctName, const std::string& path,
+                  const Parameters& parameters = {});
 
   virtual
   ~CtStorage() = default;
@@ -40,9 +160,16 @@ public: // factory
 private:
   using CtStorageCreateFunc = std::function<std::unique_ptr<CtStorage> (const Name&, const std::string&)>;
   using CtStorageFactory = std::map<std::string, CtStorageCreateFunc>;
+  using CtStorageDecoratorCreateFunc = std::function<std::unique_ptr<CtStorage> (std::unique_ptr<CtStorage>,
+                                                                                 const Name&, const std::string&,
+                                                                                 const Parameters&)>;
+  using CtStorageDecoratorFactory = std::map<std::string, CtStorageDecoratorCreateFunc>;
 
   static CtStorageFactory&
   getFactory();
+
+  static CtStorageDecoratorFactory&
+  getDecoratorFactory();
 };
 
 #define NDNREVOKE_REGISTER_CT_STORAGE(C)                         \
@@ -55,6 +182,16 @@ public:                                                          \
   }                                                              \
 } g_NdnRevoke ## C ## CtStorageRegistrationVariable
 
+#define NDNREVOKE_REGISTER_CT_STORAGE_DECORATOR(C)               \
+static class NdnRevoke ## C ## CtStorageRegistrationClass        \
+{                                                                \
+public:                                                          \
+  NdnRevoke ## C ## CtStorageRegistrationClass()                 \
+  {                                                              \
+    ::ndnrevoke::ct::CtStorage::registerCtStorageDecorator<C>(); \
+  }                                                              \
+} g_NdnRevoke ## C ## CtStorageRegistrationVariable
+
 } // namespace ct
 } // namespace ndnrevoke
 
@@ -0,0 +1,347 @@
+#include "ct-trie.hpp"
+
+#include <limits>
+
+namespace ndnrevoke {
+namespace ct {
+
+const std::string CtTrie::STORAGE_TYPE = "ct-storage-trie";
+NDNREVOKE_REGISTER_CT_STORAGE(CtTrie);
+
+const uint32_t CtTrie::ROOT = 0;
+const uint32_t CtTrie::NONE = std::numeric_limits<uint32_t>::max();
+
+namespace {
+
+/**
+ * @brief Encode one component like CtStorage::encodeSortKey, so that keys compare in
+ *        NDN canonical order.
+ */
+std::string
+makeComponentKey(const Name::Component& component)
+{
+  std::string key;
+  key.reserve(8 + component.value_size());
+  auto appendUint32 = [&key] (uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      key.push_back(static_cast<char>(value >> shift));
+    }
+  };
+  appendUint32(component.type());
+  appendUint32(static_cast<uint32_t>(component.value_size()));
+  key.append(reinterpret_cast<const char*>(component.value()), component.value_size());
+  return key;
+}
+
+Name::Component
+parseComponentKey(const std::string& key)
+{
+  return CtStorage::decodeSortKey(make_span(reinterpret_cast<const uint8_t*>(key.data()), key.size())).get(0);
+}
+
+} // namespace
+
+CtTrie::CtTrie(const Name& ctName, const std::string& path)
+  : CtStorage()
+  , m_nodes(1)
+{
+}
+
+std::vector<uint32_t>::const_iterator
+CtTrie::findChild(uint32_t node, const std::string& key) const
+{
+  const auto& children = m_nodes[node].children;
+  return std::lower_bound(children.begin(), children.end(), key,
+                          [this] (uint32_t child, const std::string& key) {
+                            return *m_components[m_nodes[child].component].key < key;
+                          });
+}
+
+uint32_t
+CtTrie::findNode(const Name& name) const
+{
+  uint32_t node = ROOT;
+  for (const auto& component : name) {
+    auto key = makeComponentKey(component);
+    auto child = findChild(node, key);
+    if (child == m_nodes[node].children.end() || *m_components[m_nodes[*child].component].key != key) {
+      return NONE;
+    }
+    node = *child;
+  }
+  return node;
+}
+
+uint32_t
+CtTrie::allocateNode(uint32_t component, uint32_t parent)
+{
+  uint32_t node;
+  if (!m_freeNodes.empty()) {
+    node = m_freeNodes.back();
+    m_freeNodes.pop_back();
+  }
+  else {
+    node = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+  }
+  m_nodes[node].component = component;
+  m_nodes[node].parent = parent;
+  return node;
+}
+
+uint32_t
+CtTrie::internComponent(const std::string& key)
+{
+  auto it = m_componentIds.find(key);
+  if (it == m_componentIds.end()) {
+    uint32_t component;
+    if (!m_freeComponents.empty()) {
+      component = m_freeComponents.back();
+      m_freeComponents.pop_back();
+    }
+    else {
+      component = static_cast<uint32_t>(m_components.size());
+      m_components.emplace_back();
+    }
+    it = m_componentIds.emplace(key, component).first;
+    m_components[component].key = &it->first;
+  }
+  m_components[it->second].nRefs++;
+  return it->second;
+}
+
+void
+CtTrie::releaseComponent(uint32_t component)
+{
+  if (--m_components[component].nRefs > 0) {
+    return;
+  }
+  std::string key = *m_components[component].key;
+  m_componentIds.erase(key);
+  m_components[component].key = nullptr;
+  m_freeComponents.push_back(component);
+}
+
+void
+CtTrie::addData(Data data)
+{
+  const Name& name = data.getName();
+  uint32_t existing = findNode(name);
+  if (existing != NONE && m_nodes[existing].wire != nullptr) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " already exists"));
+  }
+
+  uint32_t node = ROOT;
+  for (const auto& component : name) {
+    auto key = makeComponentKey(component);
+    auto child = findChild(node, key);
+    if (child != m_nodes[node].children.end() && *m_components[m_nodes[*child].component].key == key) {
+      node = *child;
+      continue;
+    }
+    // allocating may move the nodes, remember the position only
+    auto position = child - m_nodes[node].children.begin();
+    uint32_t newNode = allocateNode(internComponent(key), node);
+    auto& children = m_nodes[node].children;
+    children.insert(children.begin() + position, newNode);
+    node = newNode;
+  }
+
+  // do not keep alive a larger buffer the Data was decoded from
+  const Block& wire = data.wireEncode();
+  auto buffer = wire.getBuffer();
+  if (buffer->size() != wire.size()) {
+    buffer = std::make_shared<Buffer>(wire.begin(), wire.end());
+  }
+  m_nodes[node].wire = std::move(buffer);
+}
+
+std::shared_ptr<const Data>
+CtTrie::findData(const Name& name)
+{
+  uint32_t node = findNode(name);
+  if (node == NONE || m_nodes[node].wire == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<const Data>(Block(m_nodes[node].wire));
+}
+
+uint32_t
+CtTrie::findLastNode(uint32_t node) const
+{
+  // every leaf but the root holds a record, and a node sorts before its children
+  while (!m_nodes[node].children.empty()) {
+    node = m_nodes[node].children.back();
+  }
+  return node;
+}
+
+Name
+CtTrie::makeName(uint32_t node) const
+{
+  std::vector<uint32_t> path;
+  for (; node != ROOT; node = m_nodes[node].parent) {
+    path.push_back(node);
+  }
+  Name name;
+  for (auto it = path.rbegin(); it != path.rend(); ++it) {
+    name.append(parseComponentKey(*m_components[m_nodes[*it].component].key));
+  }
+  return name;
+}
+
+std::shared_ptr<const Data>
+CtTrie::findLatestData(const Name& prefix)
+{
+  uint32_t node = findNode(prefix);
+  if (node == NONE) {
+    return nullptr;
+  }
+  node = findLastNode(node);
+  if (m_nodes[node].wire == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<const Data>(Block(m_nodes[node].wire));
+}
+
+void
+CtTrie::deleteData(const Name& name)
+{
+  uint32_t node = findNode(name);
+  if (node == NONE || m_nodes[node].wire == nullptr) {
+    NDN_THROW(std::runtime_error("Data for " + name.toUri() + " does not exists"));
+  }
+  m_nodes[node].wire.reset();
+
+  // prune the branch that no longer leads to a record
+  while (node != ROOT && m_nodes[node].wire == nullptr && m_nodes[node].children.empty()) {
+    uint32_t parent = m_nodes[node].parent;
+    auto& siblings = m_nodes[parent].children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+    releaseComponent(m_nodes[node].component);
+    m_nodes[node] = Node();
+    m_freeNodes.push_back(node);
+    node = parent;
+  }
+}
+
+void
+CtTrie::visitSubtree(uint32_t node, Name& name, const NameVisitor& visitor) const
+{
+  if (m_nodes[node].wire != nullptr) {
+    visitor(name);
+  }
+  for (uint32_t child : m_nodes[node].children) {
+    name.append(parseComponentKey(*m_components[m_nodes[child].component].key));
+    visitSubtree(child, name, visitor);
+    name.erase(-1);
+  }
+}
+
+void
+CtTrie::visitNames(const Name& prefix, const NameVisitor& visitor)
+{
+  uint32_t node = findNode(prefix);
+  if (node == NONE) {
+    return;
+  }
+  Name name(prefix);
+  visitSubtree(node, name, visitor);
+}
+
+std::vector<Name>
+CtTrie::listNames(const Name& prefix, const optional<Name>& after, size_t limit)
+{
+  std::vector<Name> names;
+  uint32_t node = findNode(prefix);
+  if (limit == 0 || node == NONE) {
+    return names;
+  }
+
+  // the nodes from the prefix down, each with the position of its next child to walk
+  std::vector<std::pair<uint32_t, size_t>> path{{node, 0}};
+  Name name(prefix);
+  bool isAfter = after && *after >= prefix;
+  if (isAfter) {
+    if (!prefix.isPrefixOf(*after)) {
+      // the whole prefix range comes before after
+      return names;
+    }
+    // descend along after, the subtrees of the children past its path come after it
+    for (size_t i = prefix.size(); i < after->size(); i++) {
+      auto key = makeComponentKey(after->get(i));
+      const auto& children = m_nodes[node].children;
+      auto child = findChild(node, key);
+      path.back().second = child - children.begin();
+      if (child == children.end() || *m_components[m_nodes[*child].component].key != key) {
+        break;
+      }
+      path.back().second++;
+      node = *child;
+      name.append(after->get(i));
+      path.emplace_back(node, 0);
+    }
+  }
+  else if (m_nodes[node].wire != nullptr) {
+    names.push_back(name);
+  }
+
+  while (!path.empty() && names.size() < limit) {
+    auto& [current, position] = path.back();
+    const auto& children = m_nodes[current].children;
+    if (position == children.size()) {
+      path.pop_back();
+      if (!path.empty()) {
+        name.erase(-1);
+      }
+      continue;
+    }
+    uint32_t child = children[position++];
+    name.append(parseComponentKey(*m_components[m_nodes[child].component].key));
+    path.emplace_back(child, 0);
+    if (m_nodes[child].wire != nullptr) {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+optional<Name>
+CtTrie::findPrecedingName(const Name& prefix, const Name& name)
+{
+  uint32_t node = findNode(prefix);
+  if (node == NONE || name <= prefix) {
+    return nullopt;
+  }
+  uint32_t preceding = NONE;
+  if (!prefix.isPrefixOf(name)) {
+    // the whole prefix range comes before name
+    preceding = findLastNode(node);
+  }
+  else {
+    // descend along name; at each node on its path, the last subtree before the path, or
+    // else the node itself, precedes name and follows what was found further up
+    for (size_t i = prefix.size(); i < name.size(); i++) {
+      auto key = makeComponentKey(name.get(i));
+      const auto& children = m_nodes[node].children;
+      auto child = findChild(node, key);
+      if (child != children.begin()) {
+        preceding = findLastNode(*std::prev(child));
+      }
+      else if (m_nodes[node].wire != nullptr) {
+        preceding = node;
+      }
+      if (child == children.end() || *m_components[m_nodes[*child].component].key != key) {
+        break;
+      }
+      node = *child;
+    }
+  }
+  if (preceding == NONE || m_nodes[preceding].wire == nullptr) {
+    return nullopt;
+  }
+  return makeName(preceding);
+}
+
+} // namespace ct
+} // namespace ndnrevoke
@@ -0,0 +1,128 @@
+#ifndef NDNREVOKE_CT_TRIE_HPP
+#define NDNREVOKE_CT_TRIE_HPP
+
+#include "ct-storage.hpp"
+
+#include <unordered_map>
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief In-memory CT storage built on a name component trie.
+ *
+ * Record names share long prefixes (record zone, REVOKE, key id, issuer), so each name
+ * component is interned once and the trie nodes, allocated from an index-based arena,
+ * only refer to it by id.  A node carries the wire of the record ending at it; no Name or
+ * decoded Data is kept, and lookups decode a Data over the shared wire.
+ *
+ * Children are ordered like their components in NDN canonical order, so prefix lookups, the
+ * enumeration of a record zone and the lookups of the names around a name walk the subtree
+ * of the prefix directly.
+ */
+class CtTrie : public CtStorage
+{
+public:
+  CtTrie(const Name& ctName = Name(), const std::string& path = "");
+  const static std::string STORAGE_TYPE;
+
+public:
+  void
+  addData(Data data) override;
+
+  std::shared_ptr<const Data>
+  findData(const Name& name) override;
+
+  std::shared_ptr<const Data>
+  findLatestData(const Name& prefix) override;
+
+  void
+  deleteData(const Name& name) override;
+
+  void
+  visitNames(const Name& prefix, const NameVisitor& visitor) override;
+
+  std::vector<Name>
+  listNames(const Name& prefix, const optional<Name>& after, size_t limit) override;
+
+  optional<Name>
+  findPrecedingName(const Name& prefix, const Name& name) override;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  struct Node
+  {
+    uint32_t component = 0; // unused for the root
+    uint32_t parent = 0;
+    // sorted in NDN canonical order of the components
+    std::vector<uint32_t> children;
+    // wire of the record ending at this node, if any
+    ConstBufferPtr wire;
+  };
+
+  struct Component
+  {
+    // key in m_componentIds, laid out like one component of CtStorage::encodeSortKey
+    const std::string* key = nullptr;
+    uint32_t nRefs = 0;
+  };
+
+  /**
+   * @return the node of @p name, or NONE
+   */
+  uint32_t
+  findNode(const Name& name) const;
+
+  /**
+   * @return position of the child of @p node with @p key, or where it would be inserted
+   */
+  std::vector<uint32_t>::const_iterator
+  findChild(uint32_t node, const std::string& key) const;
+
+  uint32_t
+  allocateNode(uint32_t component, uint32_t parent);
+
+  uint32_t
+  internComponent(const std::string& key);
+
+  void
+  releaseComponent(uint32_t component);
+
+  void
+  visitSubtree(uint32_t node, Name& name, const NameVisitor& visitor) const;
+
+  /**
+   * @return the last node of the subtree of @p node in NDN canonical order
+   */
+  uint32_t
+  findLastNode(uint32_t node) const;
+
+  Name
+  makeName(uint32_t node) const;
+
+  size_t
+  getNNodes() const
+  {
+    return m_nodes.size() - m_freeNodes.size();
+  }
+
+  size_t
+  getNComponents() const
+  {
+    return m_componentIds.size();
+  }
+
+  static const uint32_t ROOT;
+  static const uint32_t NONE;
+
+NDNREVOKE_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::vector<Node> m_nodes;
+  std::vector<uint32_t> m_freeNodes;
+  std::unordered_map<std::string, uint32_t> m_componentIds;
+  std::vector<Component> m_components;
+  std::vector<uint32_t> m_freeComponents;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_CT_TRIE_HPP
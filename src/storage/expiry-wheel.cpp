@@ -0,0 +1,75 @@
+#include "expiry-wheel.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+ExpiryWheel::ExpiryWheel(time::milliseconds tick, size_t nSlots, time::system_clock::time_point now)
+  : m_tick(tick)
+  , m_slots(nSlots)
+{
+  if (tick <= time::milliseconds::zero() || nSlots == 0) {
+    NDN_THROW(std::invalid_argument("ExpiryWheel needs a positive tick and at least one slot"));
+  }
+  m_cursor = toTick(now);
+}
+
+uint64_t
+ExpiryWheel::toTick(time::system_clock::time_point timePoint) const
+{
+  auto sinceEpoch = time::toUnixTimestamp(timePoint);
+  if (sinceEpoch <= time::milliseconds::zero()) {
+    return 0;
+  }
+  return static_cast<uint64_t>(sinceEpoch.count() / m_tick.count());
+}
+
+void
+ExpiryWheel::insert(const Name& name, time::system_clock::time_point expiry)
+{
+  // a tick already swept is only visited again after a whole revolution
+  uint64_t tick = std::max(toTick(expiry), m_cursor);
+  m_slots[tick % m_slots.size()].push_back({name, expiry});
+  m_size++;
+}
+
+bool
+ExpiryWheel::advance(time::system_clock::time_point now, size_t budget, const ExpiryCallback& onExpired)
+{
+  // only the ticks that are over are swept, so every record of a swept slot is examined
+  // after its expiry tick
+  uint64_t nowTick = toTick(now);
+  // one revolution visits every slot, skip the older ones
+  if (m_cursor + m_slots.size() < nowTick) {
+    m_cursor = nowTick - m_slots.size();
+    m_slotOffset = 0;
+  }
+
+  while (m_cursor < nowTick) {
+    auto& slot = m_slots[m_cursor % m_slots.size()];
+    while (m_slotOffset < slot.size()) {
+      if (budget == 0) {
+        return false;
+      }
+      budget--;
+      if (slot[m_slotOffset].expiry > now) {
+        m_slotOffset++;
+        continue;
+      }
+      // unordered removal, the last entry takes the place of the expired one
+      Name name = std::move(slot[m_slotOffset].name);
+      slot[m_slotOffset] = std::move(slot.back());
+      slot.pop_back();
+      m_size--;
+      onExpired(name);
+    }
+    if (slot.capacity() > 2 * slot.size()) {
+      slot.shrink_to_fit();
+    }
+    m_cursor++;
+    m_slotOffset = 0;
+  }
+  return true;
+}
+
+} // namespace ct
+} // namespace ndnrevoke
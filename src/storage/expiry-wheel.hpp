@@ -0,0 +1,77 @@
+#ifndef NDNREVOKE_EXPIRY_WHEEL_HPP
+#define NDNREVOKE_EXPIRY_WHEEL_HPP
+
+#include "revocation-common.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Hashed timer wheel of record expiry times.
+ *
+ * A record is kept in the slot of its expiry tick modulo the number of slots.  The wheel
+ * is advanced slot by slot up to the current time; a record whose expiry is further than
+ * one revolution away stays in its slot and is looked at again on the next revolution.
+ * advance() examines a bounded number of records per call and resumes where it stopped,
+ * so the caller can spread a large sweep over several events.
+ */
+class ExpiryWheel
+{
+public:
+  using ExpiryCallback = std::function<void(const Name&)>;
+
+  /**
+   * @param tick duration covered by one slot
+   * @param nSlots number of slots in one revolution
+   */
+  ExpiryWheel(time::milliseconds tick, size_t nSlots,
+              time::system_clock::time_point now = time::system_clock::now());
+
+  /**
+   * @brief Schedule the expiry of @p name, a time in the past expires once the current tick is over.
+   */
+  void
+  insert(const Name& name, time::system_clock::time_point expiry);
+
+  /**
+   * @brief Expire the records due at @p now, examining at most @p budget records.
+   * @return whether the wheel has caught up with @p now
+   */
+  bool
+  advance(time::system_clock::time_point now, size_t budget, const ExpiryCallback& onExpired);
+
+  time::milliseconds
+  getTick() const
+  {
+    return m_tick;
+  }
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+private:
+  uint64_t
+  toTick(time::system_clock::time_point timePoint) const;
+
+private:
+  struct Entry
+  {
+    Name name;
+    time::system_clock::time_point expiry;
+  };
+
+  time::milliseconds m_tick;
+  std::vector<std::vector<Entry>> m_slots;
+  // next tick to sweep, and the position reached in its slot
+  uint64_t m_cursor;
+  size_t m_slotOffset = 0;
+  size_t m_size = 0;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_EXPIRY_WHEEL_HPP
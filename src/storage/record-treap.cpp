@@ -0,0 +1,190 @@
+#include "record-treap.hpp"
+
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndnrevoke {
+namespace ct {
+
+struct RecordTreap::Node
+{
+  Value data;
+  // max-heap order, random so that the expected depth is O(log n) for any insertion order
+  uint32_t priority;
+  NodePtr left;
+  NodePtr right;
+
+  const Name&
+  getName() const
+  {
+    return data->getName();
+  }
+};
+
+RecordTreap::NodePtr
+RecordTreap::copyNode(const Node& node, NodePtr left, NodePtr right)
+{
+  return std::make_shared<const Node>(Node{node.data, node.priority, std::move(left), std::move(right)});
+}
+
+std::pair<RecordTreap::NodePtr, RecordTreap::NodePtr>
+RecordTreap::split(const NodePtr& tree, const Name& name)
+{
+  // names before @p name on the left, the others on the right
+  if (tree == nullptr) {
+    return {};
+  }
+  if (tree->getName() < name) {
+    auto [left, right] = split(tree->right, name);
+    return {copyNode(*tree, tree->left, std::move(left)), std::move(right)};
+  }
+  auto [left, right] = split(tree->left, name);
+  return {std::move(left), copyNode(*tree, std::move(right), tree->right)};
+}
+
+RecordTreap::NodePtr
+RecordTreap::merge(const NodePtr& left, const NodePtr& right)
+{
+  // every name of @p left is before every name of @p right
+  if (left == nullptr) {
+    return right;
+  }
+  if (right == nullptr) {
+    return left;
+  }
+  if (left->priority > right->priority) {
+    return copyNode(*left, left->left, merge(left->right, right));
+  }
+  return copyNode(*right, merge(left, right->left), right->right);
+}
+
+RecordTreap::NodePtr
+RecordTreap::insert(const NodePtr& tree, const NodePtr& node)
+{
+  if (tree == nullptr || node->priority > tree->priority) {
+    auto [left, right] = split(tree, node->getName());
+    return copyNode(*node, std::move(left), std::move(right));
+  }
+  if (node->getName() < tree->getName()) {
+    return copyNode(*tree, insert(tree->left, node), tree->right);
+  }
+  return copyNode(*tree, tree->left, insert(tree->right, node));
+}
+
+RecordTreap::NodePtr
+RecordTreap::erase(const NodePtr& tree, const Name& name)
+{
+  // @p name must be in @p tree
+  if (name < tree->getName()) {
+    return copyNode(*tree, erase(tree->left, name), tree->right);
+  }
+  if (tree->getName() < name) {
+    return copyNode(*tree, tree->left, erase(tree->right, name));
+  }
+  return merge(tree->left, tree->right);
+}
+
+RecordTreap::Value
+RecordTreap::find(const Name& name) const
+{
+  const Node* node = m_root.get();
+  while (node != nullptr) {
+    int order = name.compare(node->getName());
+    if (order == 0) {
+      return node->data;
+    }
+    node = order < 0 ? node->left.get() : node->right.get();
+  }
+  return nullptr;
+}
+
+RecordTreap::Value
+RecordTreap::findLast(const Name& prefix) const
+{
+  // the last node before the first name past the prefix range
+  Name bound = prefix.empty() ? Name() : prefix.getSuccessor();
+  const Node* last = nullptr;
+  const Node* node = m_root.get();
+  while (node != nullptr) {
+    if (prefix.empty() || node->getName() < bound) {
+      last = node;
+      node = node->right.get();
+    }
+    else {
+      node = node->left.get();
+    }
+  }
+  if (last == nullptr || !prefix.isPrefixOf(last->getName())) {
+    return nullptr;
+  }
+  return last->data;
+}
+
+RecordTreap::Value
+RecordTreap::findBefore(const Name& name) const
+{
+  const Node* last = nullptr;
+  const Node* node = m_root.get();
+  while (node != nullptr) {
+    if (node->getName() < name) {
+      last = node;
+      node = node->right.get();
+    }
+    else {
+      node = node->left.get();
+    }
+  }
+  return last == nullptr ? nullptr : last->data;
+}
+
+void
+RecordTreap::insert(Value data)
+{
+  // a replaced Data leaves first, names stay unique in the tree
+  erase(data->getName());
+  auto node = std::make_shared<const Node>(Node{std::move(data), ndn::random::generateWord32(), nullptr, nullptr});
+  m_root = insert(m_root, node);
+  m_size++;
+}
+
+bool
+RecordTreap::erase(const Name& name)
+{
+  if (find(name) == nullptr) {
+    return false;
+  }
+  m_root = erase(m_root, name);
+  m_size--;
+  return true;
+}
+
+void
+RecordTreap::visit(const Name& from, bool isInclusive, const Visitor& visitor) const
+{
+  // hold the current version, the visitor may replace m_root
+  NodePtr root = m_root;
+  std::vector<const Node*> stack;
+  const Node* node = root.get();
+  while (node != nullptr) {
+    int order = node->getName().compare(from);
+    if (order > 0 || (order == 0 && isInclusive)) {
+      stack.push_back(node);
+      node = node->left.get();
+    }
+    else {
+      node = node->right.get();
+    }
+  }
+  while (!stack.empty()) {
+    node = stack.back();
+    stack.pop_back();
+    if (!visitor(node->data)) {
+      return;
+    }
+    for (node = node->right.get(); node != nullptr; node = node->left.get()) {
+      stack.push_back(node);
+    }
+  }
+}
+
+} // namespace ct
+} // namespace ndnrevoke
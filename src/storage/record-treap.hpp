@@ -0,0 +1,100 @@
+#ifndef NDNREVOKE_RECORD_TREAP_HPP
+#define NDNREVOKE_RECORD_TREAP_HPP
+
+#include "revocation-common.hpp"
+
+namespace ndnrevoke {
+namespace ct {
+
+/**
+ * @brief Persistent ordered map of Data by name, in NDN canonical order.
+ *
+ * The map is a treap whose nodes are immutable and shared: an update copies the O(log n)
+ * nodes on its path and leaves every other version intact.  Copying a RecordTreap is
+ * therefore an O(1) snapshot, which stays valid and unchanged while the original is
+ * updated, and may be read from another thread.  A node is reclaimed when the last
+ * version referring to it is gone.
+ */
+class RecordTreap
+{
+public:
+  using Value = std::shared_ptr<const Data>;
+  /**
+   * @return whether to continue the visit
+   */
+  using Visitor = std::function<bool(const Value&)>;
+
+  /**
+   * @return the Data named @p name, or nullptr
+   */
+  Value
+  find(const Name& name) const;
+
+  /**
+   * @return the last Data whose name starts with @p prefix, or nullptr
+   */
+  Value
+  findLast(const Name& prefix) const;
+
+  /**
+   * @return the last Data whose name comes before @p name, or nullptr
+   */
+  Value
+  findBefore(const Name& name) const;
+
+  /**
+   * @brief Insert @p data, replacing the Data with the same name if any.
+   */
+  void
+  insert(Value data);
+
+  /**
+   * @return whether a Data named @p name was removed
+   */
+  bool
+  erase(const Name& name);
+
+  /**
+   * @brief Visit the Data in order, from the first one named @p from (or after it if
+   *        @p isInclusive is false) until @p visitor returns false.
+   *
+   * The visit reads the version of the map at the time of the call, so @p visitor may
+   * update the map.
+   */
+  void
+  visit(const Name& from, bool isInclusive, const Visitor& visitor) const;
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+private:
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+
+  static NodePtr
+  copyNode(const Node& node, NodePtr left, NodePtr right);
+
+  static std::pair<NodePtr, NodePtr>
+  split(const NodePtr& tree, const Name& name);
+
+  static NodePtr
+  merge(const NodePtr& left, const NodePtr& right);
+
+  static NodePtr
+  insert(const NodePtr& tree, const NodePtr& node);
+
+  static NodePtr
+  erase(const NodePtr& tree, const Name& name);
+
+private:
+  NodePtr m_root;
+  size_t m_size = 0;
+};
+
+} // namespace ct
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_RECORD_TREAP_HPP
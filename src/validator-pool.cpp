@@ -0,0 +1,71 @@
+#include "validator-pool.hpp"
+
+namespace ndnrevoke::ct {
+
+NDN_LOG_INIT(ndnrevoke.validator);
+
+ValidatorPool::ValidatorPool(boost::asio::io_service& io, const std::string& schemaFile, size_t nWorkers,
+                             const FaceFactory& makeFace)
+  : m_io(io)
+{
+  for (size_t i = 0; i < nWorkers; i++) {
+    auto worker = std::make_unique<Worker>();
+    worker->work = std::make_unique<boost::asio::io_service::work>(worker->io);
+    worker->face = makeFace ? makeFace(worker->io) : std::make_unique<ndn::Face>(worker->io);
+    worker->validator = std::make_unique<ndn::ValidatorConfig>(*worker->face);
+    try {
+      worker->validator->load(schemaFile);
+    }
+    catch (const std::exception& e) {
+      NDN_THROW(std::runtime_error("Validator worker cannot load " + schemaFile + ": " + e.what()));
+    }
+    // the face and the validator are only touched by the thread from now on
+    auto w = worker.get();
+    worker->thread = std::thread([w] { w->io.run(); });
+    m_workers.push_back(std::move(worker));
+  }
+  NDN_LOG_DEBUG("Started " << nWorkers << " validator workers");
+}
+
+ValidatorPool::~ValidatorPool()
+{
+  for (auto& worker : m_workers) {
+    auto w = worker.get();
+    w->io.post([w] {
+      w->validator.reset();
+      w->face.reset();
+      w->io.stop();
+    });
+    w->work.reset();
+    w->thread.join();
+  }
+}
+
+void
+ValidatorPool::validate(const Data& data, const ndn::security::DataValidationSuccessCallback& successCb,
+                        const ndn::security::DataValidationFailureCallback& failureCb)
+{
+  auto w = m_workers[m_next++ % m_workers.size()].get();
+  // the wire encoding is immutable, the Data is rebuilt on each side from it
+  Block wire = data.wireEncode();
+  std::weak_ptr<bool> isAlive = m_isAlive;
+  w->io.post([this, w, wire, isAlive, successCb, failureCb] {
+    w->validator->validate(Data(wire),
+      [this, wire, isAlive, successCb] (const Data&) {
+        m_io.post([wire, isAlive, successCb] {
+          if (!isAlive.expired()) {
+            successCb(Data(wire));
+          }
+        });
+      },
+      [this, wire, isAlive, failureCb] (const Data&, const ndn::security::ValidationError& error) {
+        m_io.post([wire, isAlive, failureCb, error] {
+          if (!isAlive.expired()) {
+            failureCb(Data(wire), error);
+          }
+        });
+      });
+  });
+}
+
+} // namespace ndnrevoke::ct
@@ -0,0 +1,61 @@
+#ifndef NDNREVOKE_VALIDATOR_POOL_HPP
+#define NDNREVOKE_VALIDATOR_POOL_HPP
+
+#include "revocation-common.hpp"
+
+#include <thread>
+
+namespace ndnrevoke::ct {
+
+/**
+ * @brief Validates Data on worker threads against a trust schema.
+ *
+ * A Validator and its Face run on one thread, so every worker owns an io_service, a Face
+ * made by the FaceFactory, and a ValidatorConfig loaded from the trust schema; the
+ * certificates a worker needs are fetched through its own Face.  Data are handed to the
+ * workers in turn, and the callbacks are invoked on the io_service of the pool.
+ */
+class ValidatorPool : boost::noncopyable
+{
+public:
+  using FaceFactory = std::function<std::unique_ptr<ndn::Face>(boost::asio::io_service&)>;
+
+  /**
+   * @param makeFace makes the Face of a worker, a Face to the local forwarder by default
+   * @throw std::runtime_error the trust schema cannot be loaded
+   */
+  ValidatorPool(boost::asio::io_service& io, const std::string& schemaFile, size_t nWorkers,
+                const FaceFactory& makeFace = nullptr);
+
+  ~ValidatorPool();
+
+  void
+  validate(const Data& data, const ndn::security::DataValidationSuccessCallback& successCb,
+           const ndn::security::DataValidationFailureCallback& failureCb);
+
+  size_t
+  size() const
+  {
+    return m_workers.size();
+  }
+
+private:
+  struct Worker
+  {
+    boost::asio::io_service io;
+    std::unique_ptr<boost::asio::io_service::work> work;
+    std::unique_ptr<ndn::Face> face;
+    std::unique_ptr<ndn::ValidatorConfig> validator;
+    std::thread thread;
+  };
+
+  boost::asio::io_service& m_io;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  size_t m_next = 0;
+  // results posted after the pool is gone are dropped
+  std::shared_ptr<bool> m_isAlive = std::make_shared<bool>(true);
+};
+
+} // namespace ndnrevoke::ct
+
+#endif // NDNREVOKE_VALIDATOR_POOL_HPP
@@ -58,10 +58,10 @@ BOOST_AUTO_TEST_CASE(AppendCtStateFetch)
   validator.load("tests/unit-tests/config-files/trust-schema.conf");
 
   Ct ct(identity.getName(), topic, face, m_keyChain, validator);
-  ct.listen([cert2] (auto i) -> tlv::AppendStatus {
+  ct.listen([cert2] (auto&&, auto& i, auto& done) {
     BOOST_CHECK_EQUAL(i.getName(), cert2.getName());
     BOOST_CHECK_EQUAL(i.getContent().value_size(), cert2.getContent().value_size());
-    return tlv::AppendStatus::SUCCESS;
+    done(tlv::AppendStatus::SUCCESS);
   });
   advanceClocks(time::milliseconds(20), 60);
 
@@ -71,13 +71,109 @@ BOOST_AUTO_TEST_CASE(AppendCtStateFetch)
   advanceClocks(time::milliseconds(20), 60);
 
   auto submission = clientOps.makeSubmission({cert2});
-  m_keyChain.sign(*submission, ndn::signingByIdentity(identity2));
-  face.receive(*submission);
+  BOOST_REQUIRE_EQUAL(submission.size(), 1);
+  m_keyChain.sign(*submission[0], ndn::signingByIdentity(identity2));
+  face.receive(*submission[0]);
   advanceClocks(time::milliseconds(20), 60);
   face.receive(cert2);
   advanceClocks(time::milliseconds(20), 60);
 }
 
+BOOST_AUTO_TEST_CASE(AppendMalformedSubmission)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto identity2 = addSubCertificate(Name("/ndn/site2/abc"), identity);
+  auto cert2 = identity2.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  ndn::ValidatorConfig validator{face};
+  Name topic = Name(identity.getName()).append("append");
+  uint64_t nonce = ndn::random::generateSecureWord64();
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+
+  Ct ct(identity.getName(), topic, face, m_keyChain, validator);
+  size_t nUpdated = 0;
+  ct.listen([&nUpdated] (auto&&, auto&&, auto& done) {
+    nUpdated++;
+    done(tlv::AppendStatus::SUCCESS);
+  });
+  advanceClocks(time::milliseconds(20), 60);
+
+  // a retransmitted notification does not fetch the submission again
+  ClientOptions clientOps(identity2.getName(), topic, nonce, nullptr, nullptr);
+  face.receive(*clientOps.makeNotification());
+  face.receive(*clientOps.makeNotification());
+  advanceClocks(time::milliseconds(20), 60);
+  Name submissionName = Name(identity2.getName()).append("msg").append(topic).appendNumber(nonce);
+  BOOST_CHECK_EQUAL(std::count_if(face.sentInterests.begin(), face.sentInterests.end(),
+                                  [&] (const Interest& i) { return submissionName.isPrefixOf(i.getName()); }), 1);
+  BOOST_CHECK_EQUAL(ct.m_inFlight.size(), 1);
+
+  // an unknown critical TLV after the Data
+  auto submission = clientOps.makeSubmission({cert2});
+  Block content = submission[0]->getContent();
+  content.parse();
+  content.push_back(ndn::makeNonNegativeIntegerBlock(201, 1));
+  content.encode();
+  submission[0]->setContent(content);
+  m_keyChain.sign(*submission[0], ndn::signingByIdentity(identity2));
+  face.receive(*submission[0]);
+  advanceClocks(time::milliseconds(20), 60);
+  face.receive(cert2);
+  advanceClocks(time::milliseconds(20), 60);
+
+  BOOST_CHECK_EQUAL(nUpdated, 0);
+  BOOST_CHECK(ct.m_inFlight.empty());
+  Name ackName = clientOps.makeNotification()->getName();
+  auto ack = std::find_if(face.sentData.begin(), face.sentData.end(),
+                          [&] (const Data& data) { return data.getName() == ackName; });
+  BOOST_REQUIRE(ack != face.sentData.end());
+  auto statuses = ClientOptions::praseAck(*ack);
+  BOOST_REQUIRE_EQUAL(statuses.size(), 1);
+  BOOST_CHECK(statuses.front() == tlv::AppendStatus::FAILURE_VALIDATION_PROTO);
+}
+
+BOOST_AUTO_TEST_CASE(AppendOutOfOrderSegments)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  DummyClientFace face(io, m_keyChain, {true, true});
+  ndn::ValidatorConfig validator{face};
+  Name topic = Name(identity.getName()).append("append");
+  Ct ct(identity.getName(), topic, face, m_keyChain, validator);
+  std::vector<Name> updated;
+  ct.listen([&updated] (auto&&, const Data& data, auto& done) {
+    updated.push_back(data.getName());
+    done(tlv::AppendStatus::SUCCESS);
+  });
+
+  auto makeSegment = [this] (uint64_t segmentNo) {
+    Data item(Name("/ndn/site2/abc/item").appendNumber(segmentNo));
+    m_keyChain.sign(item, ndn::signingWithSha256());
+    Block content(ndn::tlv::Content);
+    content.push_back(item.wireEncode());
+    content.encode();
+    Data segment(Name("/ndn/site2/abc/msg/submission").appendSegment(segmentNo));
+    segment.setContent(content);
+    return segment;
+  };
+  auto submission = std::make_shared<Ct::Submission>();
+  submission->name = "/ndn/site2/abc/msg/submission";
+
+  // a segment ahead of the next one waits for it
+  ct.onSegment(makeSegment(2), submission);
+  BOOST_CHECK(updated.empty());
+  ct.onSegment(makeSegment(0), submission);
+  BOOST_CHECK_EQUAL(updated.size(), 1);
+  ct.onSegment(makeSegment(1), submission);
+  BOOST_REQUIRE_EQUAL(updated.size(), 3);
+  for (uint64_t i = 0; i < 3; i++) {
+    BOOST_CHECK_EQUAL(updated[i], Name("/ndn/site2/abc/item").appendNumber(i));
+  }
+  BOOST_CHECK(submission->buffered.empty());
+  BOOST_CHECK_EQUAL(submission->nData, 3);
+}
+
 BOOST_AUTO_TEST_CASE(AppendHandleClientCallback)
 {
   auto identity = addIdentity(Name("/ndn"));
@@ -102,15 +198,15 @@ BOOST_AUTO_TEST_CASE(AppendHandleClientCallback)
   m_keyChain.sign(appData, ndn::signingByIdentity(identity2));
 
   Ct ct(identity.getName(), topic, face, m_keyChain, validator);
-  ct.listen([appData] (auto i) -> tlv::AppendStatus {
+  ct.listen([appData] (auto&&, auto& i, auto& done) {
     BOOST_CHECK_EQUAL(i.getName(), appData.getName());
     BOOST_CHECK_EQUAL(i.getContent().value_size(), appData.getContent().value_size());
-    return tlv::AppendStatus::SUCCESS;
+    done(tlv::AppendStatus::SUCCESS);
   });
   advanceClocks(time::milliseconds(20), 60);
 
   uint64_t nonce = Client.appendData(topic, {appData}, 
-    [] (auto&&, auto& i) {
+    [] (auto&&, auto& i, auto&&) {
       Block content = i.getContent();
       content.parse();
       BOOST_CHECK_EQUAL(content.elements_size(), 1);
@@ -123,14 +219,14 @@ BOOST_AUTO_TEST_CASE(AppendHandleClientCallback)
   ClientOptions clientOps(identity2.getName(), topic, nonce,
                           nullptr, nullptr);
   auto submission = clientOps.makeSubmission({appData});
-  m_keyChain.sign(*submission, ndn::signingByIdentity(identity2));
+  m_keyChain.sign(*submission[0], ndn::signingByIdentity(identity2));
   CtOptions ctOps(topic);
   auto ack = ctOps.makeNotificationAck(clientOps, {tlv::AppendStatus::SUCCESS});
   m_keyChain.sign(*ack, ndn::signingByIdentity(identity));
 
   face.receive(*clientOps.makeNotification());
   advanceClocks(time::milliseconds(20), 60);
-  face.receive(*submission);
+  face.receive(*submission[0]);
   advanceClocks(time::milliseconds(20), 60);
   face.receive(cert2);
   advanceClocks(time::milliseconds(20), 60);
@@ -138,6 +234,188 @@ BOOST_AUTO_TEST_CASE(AppendHandleClientCallback)
   advanceClocks(time::milliseconds(20), 60);
 }
 
+BOOST_AUTO_TEST_CASE(MakeSegmentedSubmission)
+{
+  std::list<Data> dataList;
+  for (int i = 0; i < 100; i++) {
+    Data item(Name("/ndn/site1/abc/appData").appendNumber(i));
+    item.setContent(std::vector<uint8_t>(200, i));
+    m_keyChain.sign(item, ndn::signingWithSha256());
+    dataList.push_back(item);
+  }
+
+  Name topic("/ndn/append");
+  ClientOptions clientOps(Name("/ndn/site1/abc"), topic, 1, nullptr, nullptr);
+  auto segments = clientOps.makeSubmission(dataList, 2000);
+  BOOST_CHECK_GT(segments.size(), 1);
+
+  auto it = dataList.begin();
+  for (size_t i = 0; i < segments.size(); i++) {
+    BOOST_CHECK_EQUAL(segments[i]->getName(), Name(clientOps.makeInterestFilter()).appendSegment(i));
+    BOOST_CHECK_EQUAL(segments[i]->getFinalBlock()->toSegment(), segments.size() - 1);
+    // segments only hold whole Data, in order
+    Block content = segments[i]->getContent();
+    content.parse();
+    BOOST_CHECK_LE(content.value_size(), 2000);
+    for (const auto& element : content.elements()) {
+      BOOST_REQUIRE(it != dataList.end());
+      BOOST_CHECK_EQUAL(Data(element).getName(), it->getName());
+      it++;
+    }
+  }
+  BOOST_CHECK(it == dataList.end());
+}
+
+BOOST_AUTO_TEST_CASE(AppendSegmented)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto identity2 = addSubCertificate(Name("/ndn/site4/abc"), identity);
+  auto cert2 = identity2.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  DummyClientFace face2(io, m_keyChain, {true, true});
+  face.linkTo(face2);
+  ndn::ValidatorConfig validator{face};
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+  ndn::ValidatorConfig validator2{face2};
+  validator2.load("tests/unit-tests/config-files/trust-schema.conf");
+  Name topic = Name(identity.getName()).append("append");
+
+  // far more than fits into one packet
+  std::list<Data> dataList;
+  for (int i = 0; i < 200; i++) {
+    Data item(Name("/ndn/site4/abc/appData").appendNumber(i));
+    item.setContent(std::vector<uint8_t>(200, i));
+    m_keyChain.sign(item, ndn::signingByIdentity(identity2));
+    dataList.push_back(item);
+  }
+
+  Client client(identity2.getName(), face2, m_keyChain, validator2);
+  auto certFilter = face2.setInterestFilter(cert2.getKeyName(),
+    [&] (auto&&, auto&&) { face2.put(cert2); });
+
+  Ct ct(identity.getName(), topic, face, m_keyChain, validator);
+  std::set<Name> updated;
+  ct.listen([&updated] (auto&&, auto& i, auto& done) {
+    updated.insert(i.getName());
+    // the last record of the batch fails
+    done(i.getName()[-1].toNumber() == 199 ? tlv::AppendStatus::FAILURE_QUOTA : tlv::AppendStatus::SUCCESS);
+  });
+  advanceClocks(time::milliseconds(20), 60);
+
+  std::list<tlv::AppendStatus> statuses;
+  ClientOptions clientOps(identity2.getName(), topic, 1, nullptr, nullptr);
+  client.appendData(topic, dataList,
+    [&] (auto&&, auto& ack, auto&&) { statuses = clientOps.praseAck(ack); },
+    [] (auto&&...) { BOOST_ERROR("Unexpected failure"); });
+  advanceClocks(time::milliseconds(20), 100);
+
+  BOOST_CHECK_EQUAL(updated.size(), dataList.size());
+  BOOST_REQUIRE_EQUAL(statuses.size(), dataList.size());
+  BOOST_CHECK(std::all_of(statuses.begin(), std::prev(statuses.end()),
+                          [] (auto status) { return status == tlv::AppendStatus::SUCCESS; }));
+  BOOST_CHECK(statuses.back() == tlv::AppendStatus::FAILURE_QUOTA);
+}
+
+BOOST_AUTO_TEST_CASE(AppendCoalesced)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto identity2 = addSubCertificate(Name("/ndn/site5/abc"), identity);
+  auto cert2 = identity2.getDefaultKey().getDefaultCertificate();
+  auto ctCert = identity.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  DummyClientFace face2(io, m_keyChain, {true, true});
+  face.linkTo(face2);
+  ndn::ValidatorConfig validator{face};
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+  ndn::ValidatorConfig validator2{face2};
+  validator2.load("tests/unit-tests/config-files/trust-schema.conf");
+  Name topic = Name(identity.getName()).append("append");
+
+  Client client(identity2.getName(), face2, m_keyChain, validator2);
+  client.enableCoalescing(time::milliseconds(50), 10);
+  auto certFilter = face2.setInterestFilter(cert2.getKeyName(),
+    [&] (auto&&, auto&&) { face2.put(cert2); });
+
+  Ct ct(identity.getName(), topic, face, m_keyChain, validator);
+  ct.listen([] (auto&&, auto& i, auto& done) {
+    done(i.getName()[-1].toNumber() % 3 == 0 ? tlv::AppendStatus::FAILURE_QUOTA : tlv::AppendStatus::SUCCESS);
+  });
+  advanceClocks(time::milliseconds(20), 60);
+
+  std::map<Name, tlv::AppendStatus> statuses;
+  std::set<uint64_t> nonces;
+  for (int i = 0; i < 12; i++) {
+    Data item(Name("/ndn/site5/abc/appData").appendNumber(i));
+    m_keyChain.sign(item, ndn::signingByIdentity(identity2));
+    auto nonce = client.appendData(topic, {item},
+      [&statuses, ctCert] (auto& data, auto& ack, auto& statusList) {
+        // the ack of the whole submission, as signed by the CT
+        BOOST_CHECK(verifySignature(ack, ctCert));
+        BOOST_CHECK_GT(ClientOptions::praseAck(ack).size(), data.size());
+        BOOST_REQUIRE_EQUAL(statusList.size(), data.size());
+        statuses.emplace(data.front().getName(), statusList.front());
+      },
+      [] (auto&&...) { BOOST_ERROR("Unexpected failure"); });
+    nonces.insert(nonce);
+  }
+  // the first ten records are submitted right away, the other two after the window
+  BOOST_CHECK_EQUAL(nonces.size(), 2);
+  advanceClocks(time::milliseconds(20), 100);
+
+  size_t nNotifications = std::count_if(face2.sentInterests.begin(), face2.sentInterests.end(),
+    [] (const Interest& i) { return i.getName().get(-2) == Name::Component("notify"); });
+  BOOST_CHECK_EQUAL(nNotifications, 2);
+  BOOST_REQUIRE_EQUAL(statuses.size(), 12);
+  for (const auto& [name, status] : statuses) {
+    BOOST_CHECK(status == (name[-1].toNumber() % 3 == 0 ? tlv::AppendStatus::FAILURE_QUOTA
+                                                        : tlv::AppendStatus::SUCCESS));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AppendSoak)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto identity2 = addSubCertificate(Name("/ndn/site6/abc"), identity);
+  auto cert2 = identity2.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  DummyClientFace face2(io, m_keyChain, {true, true});
+  face.linkTo(face2);
+  ndn::ValidatorConfig validator{face};
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+  ndn::ValidatorConfig validator2{face2};
+  validator2.load("tests/unit-tests/config-files/trust-schema.conf");
+  Name topic = Name(identity.getName()).append("append");
+
+  Client client(identity2.getName(), face2, m_keyChain, validator2);
+  auto certFilter = face2.setInterestFilter(cert2.getKeyName(),
+    [&] (auto&&, auto&&) { face2.put(cert2); });
+  Ct ct(identity.getName(), topic, face, m_keyChain, validator);
+  ct.listen([] (auto&&, auto&&, auto& done) { done(tlv::AppendStatus::SUCCESS); });
+  advanceClocks(time::milliseconds(20), 60);
+
+  // the state of the client does not grow with the number of appends
+  size_t nAcked = 0;
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 100; i++) {
+      Data item(Name("/ndn/site6/abc/appData").appendNumber(round * 100 + i));
+      m_keyChain.sign(item, ndn::signingWithSha256());
+      client.appendData(topic, {item}, [&nAcked] (auto&&...) { nAcked++; },
+                        [] (auto&&...) { BOOST_ERROR("Unexpected failure"); });
+    }
+    BOOST_CHECK_EQUAL(client.m_submissions.size(), 100);
+    advanceClocks(time::milliseconds(20), 50);
+    BOOST_CHECK_EQUAL(client.m_submissions.size(), 0);
+    BOOST_CHECK_EQUAL(client.m_handle.m_interestFilterHandles.size(), 1);
+  }
+  BOOST_CHECK_EQUAL(nAcked, 1000);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestCtModule
 
 } // namespace tests
@@ -15,6 +15,17 @@ BOOST_AUTO_TEST_CASE(CtConfigFile)
   BOOST_CHECK_EQUAL(config.recordZones.size(), 2);
   BOOST_CHECK_EQUAL(config.recordZones.front(), Name("/ndn/site1"));
   BOOST_CHECK_EQUAL(config.recordZones.back(), Name("/ndn/site2"));
+  BOOST_CHECK_EQUAL(config.zoneQuotas[Name("/ndn/site1")], 0);
+
+  config.load("tests/unit-tests/config-files/config-ct-3");
+  BOOST_CHECK_EQUAL(config.zoneQuotas[Name("/ndn/site1")], 2000);
+  BOOST_CHECK_EQUAL(config.zoneQuotas[Name("/ndn/site2")], 1000000);
+  BOOST_CHECK_EQUAL(config.nackSigning, ndn::signingByIdentity("/ndn"));
+
+  config.load("tests/unit-tests/config-files/config-ct-6");
+  BOOST_CHECK_EQUAL(config.nackSigning.getSignerType(), ndn::security::SigningInfo::SIGNER_TYPE_SHA256);
+  BOOST_CHECK_EQUAL(config.ackSigning.getSignerType(), ndn::security::SigningInfo::SIGNER_TYPE_HMAC);
+  BOOST_CHECK_EQUAL(config.indexSigning, ndn::signingByIdentity("/ndn"));
 }
 
 BOOST_AUTO_TEST_CASE(CtConfigFileWithErrors)
@@ -0,0 +1,41 @@
+#include "storage/counting-bloom-filter.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+BOOST_AUTO_TEST_SUITE(TestCountingBloomFilter)
+
+BOOST_AUTO_TEST_CASE(InsertErase)
+{
+  CountingBloomFilter filter(1000);
+  BOOST_CHECK_EQUAL(filter.getNHashes(), 7);
+
+  for (uint64_t i = 0; i < 1000; i++) {
+    filter.insert(i * 0x9E3779B97F4A7C15);
+  }
+  for (uint64_t i = 0; i < 1000; i++) {
+    BOOST_CHECK(filter.mayContain(i * 0x9E3779B97F4A7C15));
+  }
+
+  size_t nFalsePositives = 0;
+  for (uint64_t i = 1000; i < 11000; i++) {
+    nFalsePositives += filter.mayContain(i * 0x9E3779B97F4A7C15);
+  }
+  BOOST_CHECK_LT(nFalsePositives, 300);
+
+  for (uint64_t i = 0; i < 500; i++) {
+    filter.erase(i * 0x9E3779B97F4A7C15);
+  }
+  // erasing must not introduce false negatives for the remaining digests
+  for (uint64_t i = 500; i < 1000; i++) {
+    BOOST_CHECK(filter.mayContain(i * 0x9E3779B97F4A7C15));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCountingBloomFilter
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,99 @@
+#include "storage/ct-cache.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+class CtCacheFixture : public IdentityManagementFixture
+{
+public:
+  CtCacheFixture()
+  {
+    auto created = CtStorage::createCtStorage("ct-storage-cached:ct-storage-memory", Name(), "");
+    storage.reset(dynamic_cast<CtCache*>(created.release()));
+  }
+
+  Data
+  makeData(const Name& name)
+  {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    return data;
+  }
+
+public:
+  std::unique_ptr<CtCache> storage;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCtCache, CtCacheFixture)
+
+BOOST_AUTO_TEST_CASE(Factory)
+{
+  BOOST_REQUIRE(storage != nullptr);
+  BOOST_CHECK(CtStorage::createCtStorage("ct-storage-cached:ct-storage-unknown", Name(), "") == nullptr);
+  BOOST_CHECK(CtStorage::createCtStorage("ct-storage-unknown:ct-storage-memory", Name(), "") == nullptr);
+  BOOST_CHECK_EQUAL(storage->getCapacity(), CtCache::DEFAULT_CAPACITY);
+
+  auto sized = CtStorage::createCtStorage("ct-storage-cached:ct-storage-memory", Name(), "",
+                                          {{CtCache::CAPACITY_PARAMETER, "5"}});
+  BOOST_CHECK_EQUAL(dynamic_cast<CtCache&>(*sized).getCapacity(), 5);
+  BOOST_CHECK_THROW(CtStorage::createCtStorage("ct-storage-cached:ct-storage-memory", Name(), "",
+                                               {{CtCache::CAPACITY_PARAMETER, "many"}}),
+                    std::runtime_error);
+  // storages ignore the parameters they do not use
+  BOOST_CHECK(CtStorage::createCtStorage("ct-storage-memory", Name(), "",
+                                         {{CtCache::CAPACITY_PARAMETER, "5"}}) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Coherence)
+{
+  auto data1 = makeData("/ndn/site1/abc/v1");
+
+  // a miss is remembered as a negative entry
+  BOOST_CHECK(storage->findData(data1.getName()) == nullptr);
+  BOOST_CHECK(storage->findData(data1.getName()) == nullptr);
+  BOOST_CHECK_EQUAL(storage->getCounters().nMisses, 1);
+  BOOST_CHECK_EQUAL(storage->getCounters().nNegativeHits, 1);
+  BOOST_CHECK(storage->findLatestData("/ndn/site1/abc") == nullptr);
+
+  // adding replaces the negative entries
+  storage->addData(data1);
+  BOOST_CHECK_EQUAL(*storage->findData(data1.getName()), data1);
+  BOOST_CHECK_EQUAL(storage->getCounters().nHits, 1);
+  BOOST_CHECK_EQUAL(*storage->findLatestData("/ndn/site1/abc"), data1);
+
+  auto data2 = makeData("/ndn/site1/abc/v2");
+  storage->addData(data2);
+  BOOST_CHECK_EQUAL(*storage->findLatestData("/ndn/site1/abc"), data2);
+
+  storage->deleteData(data2.getName());
+  BOOST_CHECK(storage->findData(data2.getName()) == nullptr);
+  BOOST_CHECK_EQUAL(*storage->findLatestData("/ndn/site1/abc"), data1);
+  BOOST_CHECK(storage->getInner().findData(data2.getName()) == nullptr);
+  BOOST_CHECK_GT(storage->getHitRatio(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(Eviction)
+{
+  storage->setCapacity(2);
+  std::vector<Data> records;
+  for (int i = 0; i < 3; i++) {
+    records.push_back(makeData(Name("/ndn/site1").appendNumber(i)));
+    storage->addData(records.back());
+  }
+  BOOST_CHECK_EQUAL(storage->m_exact.size(), 2);
+
+  // the least recently used record was evicted and comes back from the inner storage
+  uint64_t nMisses = storage->getCounters().nMisses;
+  BOOST_CHECK_EQUAL(*storage->findData(records[0].getName()), records[0]);
+  BOOST_CHECK_EQUAL(storage->getCounters().nMisses, nMisses + 1);
+  BOOST_CHECK_EQUAL(*storage->findData(records[2].getName()), records[2]);
+  BOOST_CHECK_EQUAL(storage->getCounters().nMisses, nMisses + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtCache
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,58 @@
+#include "storage/ct-cursor.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+BOOST_FIXTURE_TEST_SUITE(TestCtCursor, IdentityManagementFixture)
+
+BOOST_AUTO_TEST_CASE(Scan)
+{
+  // ordered backends seek to the position, the trie uses the default listing
+  for (const std::string type : {"ct-storage-memory", "ct-storage-hash", "ct-storage-trie"}) {
+    BOOST_TEST_CONTEXT(type) {
+      auto storage = CtStorage::createCtStorage(type, Name(), "");
+      BOOST_REQUIRE(storage != nullptr);
+      std::vector<Data> records;
+      for (int i = 9; i >= 0; i--) {
+        Data data(Name("/ndn/site1").appendNumber(i));
+        m_keyChain.sign(data, ndn::signingWithSha256());
+        storage->addData(data);
+        records.insert(records.begin(), data);
+      }
+      Data outside("/ndn/site2/abc");
+      m_keyChain.sign(outside, ndn::signingWithSha256());
+      storage->addData(outside);
+
+      CtCursor cursor(*storage, "/ndn/site1");
+      auto page = cursor.next(4);
+      BOOST_REQUIRE_EQUAL(page.size(), 4);
+      BOOST_CHECK_EQUAL(*page[0], records[0]);
+      BOOST_CHECK_EQUAL(*page[3], records[3]);
+      BOOST_CHECK_EQUAL(*cursor.getPosition(), records[3].getName());
+      BOOST_CHECK(!cursor.isDone());
+
+      // a record deleted ahead of the cursor is skipped
+      storage->deleteData(records[4].getName());
+
+      // resume from the position in a new cursor
+      CtCursor resumed(*storage, "/ndn/site1", cursor.getPosition());
+      page = resumed.next(4);
+      BOOST_REQUIRE_EQUAL(page.size(), 4);
+      BOOST_CHECK_EQUAL(*page[0], records[5]);
+      BOOST_CHECK_EQUAL(*page[3], records[8]);
+      page = resumed.next(4);
+      BOOST_REQUIRE_EQUAL(page.size(), 1);
+      BOOST_CHECK_EQUAL(*page[0], records[9]);
+      BOOST_CHECK(resumed.isDone());
+      BOOST_CHECK(resumed.next(4).empty());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtCursor
+
+} // namespace tests
+} // namespace ndnrevoke
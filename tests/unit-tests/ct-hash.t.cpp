@@ -0,0 +1,91 @@
+#include "storage/ct-hash.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+class CtHashFixture : public IdentityManagementFixture
+{
+public:
+  Data
+  makeData(const Name& name)
+  {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    return data;
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCtHash, CtHashFixture)
+
+BOOST_AUTO_TEST_CASE(BasicOps)
+{
+  CtHash storage;
+  auto cert1 = addIdentity(Name("/ndn/site1")).getDefaultKey().getDefaultCertificate();
+
+  BOOST_CHECK_NO_THROW(storage.addData(cert1));
+  BOOST_CHECK_THROW(storage.addData(cert1), std::runtime_error);
+  BOOST_CHECK_EQUAL(*storage.findData(cert1.getName()), cert1);
+  BOOST_CHECK(storage.findData(Name("/ndn/site2")) == nullptr);
+
+  BOOST_CHECK_NO_THROW(storage.deleteData(cert1.getName()));
+  BOOST_CHECK(storage.findData(cert1.getName()) == nullptr);
+  BOOST_CHECK_THROW(storage.deleteData(cert1.getName()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(GrowAndShift)
+{
+  CtHash storage;
+  std::vector<Data> records;
+  for (int i = 0; i < 1000; i++) {
+    records.push_back(makeData(Name("/ndn/site1").appendNumber(i)));
+    storage.addData(records.back());
+  }
+  BOOST_CHECK_GE(storage.m_tags.size(), 1024);
+
+  // deleting every other record shifts probe chains back; the rest must stay reachable
+  for (int i = 0; i < 1000; i += 2) {
+    storage.deleteData(records[i].getName());
+  }
+  for (int i = 0; i < 1000; i++) {
+    auto found = storage.findData(records[i].getName());
+    if (i % 2 == 0) {
+      BOOST_CHECK(found == nullptr);
+    }
+    else {
+      BOOST_REQUIRE(found != nullptr);
+      BOOST_CHECK_EQUAL(*found, records[i]);
+    }
+  }
+
+  size_t nNames = 0;
+  storage.visitNames(Name("/ndn/site1"), [&nNames] (const Name&) { nNames++; });
+  BOOST_CHECK_EQUAL(nNames, 500);
+}
+
+BOOST_AUTO_TEST_CASE(LatestData)
+{
+  CtHash storage;
+  std::vector<Data> versions;
+  for (uint64_t version : {1, 2, 10}) {
+    versions.push_back(makeData(Name("/ndn/site1/abc").appendVersion(version)));
+    storage.addData(versions.back());
+  }
+  auto sibling = makeData(Name("/ndn/site1/abd").appendVersion(100));
+  storage.addData(sibling);
+
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[2]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(versions[0].getName()), versions[0]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name()), sibling);
+  BOOST_CHECK(storage.findLatestData(Name("/ndn/site1/ab")) == nullptr);
+
+  storage.deleteData(versions[2].getName());
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtHash
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,59 @@
+#include "storage/ct-index.hpp"
+#include "test-common.hpp"
+#include "revoker.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+BOOST_FIXTURE_TEST_SUITE(TestCtIndex, IdentityManagementFixture)
+
+BOOST_AUTO_TEST_CASE(InsertFindErase)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  auto cert1 = addSubCertificate(Name("/ndn/site1/abc"), identity).getDefaultKey().getDefaultCertificate();
+  auto cert2 = addSubCertificate(Name("/ndn/site1/def"), identity).getDefaultKey().getDefaultCertificate();
+  revoker::Revoker revoker(m_keyChain);
+  auto record1 = revoker.revokeAsIssuer(cert1, tlv::ReasonCode::KEY_COMPROMISE);
+  auto record2 = revoker.revokeAsIssuer(cert2, tlv::ReasonCode::KEY_COMPROMISE);
+
+  CtIndex index;
+  index.insert(*record1);
+  index.insert(*record2);
+  // other Data is not indexed, and a record is counted once
+  index.insert(cert1);
+  index.insert(*record1);
+  BOOST_CHECK_EQUAL(index.size(), 2);
+
+  Name::Component issuer = record1->getName().get(record::Record::KEYID_OFFSET + 1);
+  BOOST_CHECK_EQUAL(index.find(CtIndex::Kind::ISSUER, issuer, 10).size(), 2);
+  auto firstPage = index.find(CtIndex::Kind::ISSUER, issuer, 1);
+  BOOST_REQUIRE_EQUAL(firstPage.size(), 1);
+  auto secondPage = index.find(CtIndex::Kind::ISSUER, issuer, 10, firstPage.back());
+  BOOST_REQUIRE_EQUAL(secondPage.size(), 1);
+  BOOST_CHECK_NE(secondPage.front(), firstPage.front());
+
+  auto keyHash = Sha256::computeDigest(cert2.getPublicKey());
+  auto found = index.find(CtIndex::Kind::PUBLIC_KEY_HASH, Name::Component(*keyHash), 10);
+  BOOST_REQUIRE_EQUAL(found.size(), 1);
+  BOOST_CHECK_EQUAL(found[0], record2->getName());
+
+  found = index.find(CtIndex::Kind::KEY_ID, cert1.getName().get(Certificate::KEY_ID_OFFSET), 10);
+  BOOST_REQUIRE_EQUAL(found.size(), 1);
+  BOOST_CHECK_EQUAL(found[0], record1->getName());
+
+  index.erase(*record1);
+  index.erase(*record1);
+  BOOST_CHECK_EQUAL(index.size(), 1);
+  BOOST_CHECK_EQUAL(index.find(CtIndex::Kind::ISSUER, issuer, 10).size(), 1);
+  BOOST_CHECK(index.find(CtIndex::Kind::KEY_ID, cert1.getName().get(Certificate::KEY_ID_OFFSET), 10).empty());
+
+  BOOST_CHECK(CtIndex::parseKind(Name::Component("PUBKEY-HASH")) == CtIndex::Kind::PUBLIC_KEY_HASH);
+  BOOST_CHECK(!CtIndex::parseKind(Name::Component("OTHER")));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtIndex
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,118 @@
+#include "storage/ct-ledger.hpp"
+#include "test-common.hpp"
+
+#ifdef NDNREVOKE_HAVE_LEDGERS
+
+#include <ndn-cxx/security/validator-null.hpp>
+
+#include <boost/filesystem.hpp>
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+class CtLedgerFixture : public IdentityManagementFixture
+{
+public:
+  CtLedgerFixture()
+    : dbDir((boost::filesystem::path(TMP_TESTS_PATH) / "CtLedgerTest").string())
+  {
+    boost::filesystem::remove_all(dbDir);
+    m_keyChain.createIdentity("/ndn/ct1");
+    config = cert_ledger::Config::CustomizedConfig("/ndn/broadcast/cert-ledger-dag", "/ndn/ct1", dbDir);
+  }
+
+  ~CtLedgerFixture()
+  {
+    boost::filesystem::remove_all(dbDir);
+  }
+
+  std::unique_ptr<CtLedger>
+  makeStorage()
+  {
+    return std::make_unique<CtLedger>(Name("/ndn/ct1"), *config, m_keyChain, face,
+                                      std::make_shared<ndn::security::ValidatorNull>());
+  }
+
+public:
+  ndn::util::DummyClientFace face;
+  std::string dbDir;
+  std::shared_ptr<cert_ledger::Config> config;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCtLedger, CtLedgerFixture)
+
+BOOST_AUTO_TEST_CASE(BasicOps)
+{
+  auto storage = makeStorage();
+  auto cert1 = addIdentity(Name("/ndn/site1")).getDefaultKey().getDefaultCertificate();
+  auto cert2 = addIdentity(Name("/ndn/site2")).getDefaultKey().getDefaultCertificate();
+
+  BOOST_CHECK_NO_THROW(storage->addData(cert1));
+  BOOST_CHECK_THROW(storage->addData(cert1), std::runtime_error);
+  BOOST_CHECK_NO_THROW(storage->addData(cert2));
+  // reads are served locally before the batch reaches the ledger
+  BOOST_CHECK_EQUAL(*storage->findData(cert1.getName()), cert1);
+  BOOST_CHECK_EQUAL(storage->m_pendingBlocks.size(), 2);
+
+  storage->commit();
+  BOOST_CHECK_EQUAL(storage->m_pendingBlocks.size(), 0);
+  BOOST_CHECK_EQUAL(storage->m_ledger->listRecord(storage->m_batchPrefix).size(), 1);
+
+  BOOST_CHECK_NO_THROW(storage->deleteData(cert2.getName()));
+  BOOST_CHECK(storage->findData(cert2.getName()) == nullptr);
+  storage->commit();
+}
+
+BOOST_AUTO_TEST_CASE(Reload)
+{
+  auto cert1 = addIdentity(Name("/ndn/site1")).getDefaultKey().getDefaultCertificate();
+  auto cert2 = addIdentity(Name("/ndn/site2")).getDefaultKey().getDefaultCertificate();
+  {
+    auto storage = makeStorage();
+    storage->addData(cert1);
+    storage->addData(cert2);
+    storage->commit();
+    storage->deleteData(cert2.getName());
+    storage->commit();
+  }
+
+  auto storage = makeStorage();
+  BOOST_CHECK_EQUAL(*storage->findData(cert1.getName()), cert1);
+  BOOST_CHECK(storage->findData(cert2.getName()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(SplitBatches)
+{
+  std::vector<Data> records;
+  for (int i = 0; i < 20; i++) {
+    Data data(Name("/ndn/site1/record").appendNumber(i));
+    data.setContent(std::vector<uint8_t>(1000, i));
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    records.push_back(data);
+  }
+  {
+    auto storage = makeStorage();
+    for (const auto& data : records) {
+      storage->addData(data);
+    }
+    // far more than fits in a packet, committed as several batches
+    storage->commit();
+    BOOST_CHECK(storage->m_pendingBlocks.empty());
+    BOOST_CHECK_GT(storage->m_ledger->listRecord(storage->m_batchPrefix).size(),
+                   20 * 1000 / CtLedger::MAX_BATCH_SIZE);
+  }
+
+  auto storage = makeStorage();
+  for (const auto& data : records) {
+    BOOST_CHECK(storage->findData(data.getName()) != nullptr);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtLedger
+
+} // namespace tests
+} // namespace ndnrevoke
+
+#endif // NDNREVOKE_HAVE_LEDGERS
@@ -1,6 +1,10 @@
 #include "storage/ct-memory.hpp"
 #include "test-common.hpp"
 
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
 namespace ndnrevoke {
 namespace tests {
 
@@ -23,9 +27,148 @@ BOOST_AUTO_TEST_CASE(BasicOps)
   Data result;
   BOOST_CHECK_NO_THROW(result = storage.getData(cert1.getName()));
   BOOST_CHECK_EQUAL(cert1, result);
+  BOOST_CHECK_EQUAL(*storage.findData(cert1.getName()), cert1);
+
+  // name enumeration
+  std::vector<Name> names;
+  storage.visitNames(Name("/ndn"), [&names] (const Name& name) { names.push_back(name); });
+  BOOST_CHECK_EQUAL(names.size(), 1);
+  storage.visitNames(Name("/other"), [&names] (const Name& name) { names.push_back(name); });
+  BOOST_CHECK_EQUAL(names.size(), 1);
 
   // delete operation
   BOOST_CHECK_NO_THROW(storage.deleteData(cert1.getName()));
+  BOOST_CHECK(!storage.findData(cert1.getName()));
+  BOOST_CHECK_THROW(storage.getData(cert1.getName()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(SharedLookup)
+{
+  CtMemory storage;
+  auto cert1 = addIdentity(Name("/ndn/site1")).getDefaultKey().getDefaultCertificate();
+  storage.addData(cert1);
+
+  // a hit shares the stored Data and the submitted wire instead of copying them
+  auto first = storage.findData(cert1.getName());
+  auto second = storage.findData(cert1.getName());
+  BOOST_CHECK_EQUAL(first, second);
+  BOOST_CHECK_EQUAL(first.use_count(), 3);
+  BOOST_CHECK_EQUAL(first->wireEncode().getBuffer(), cert1.wireEncode().getBuffer());
+  BOOST_CHECK_EQUAL(storage.findLatestData(Name("/ndn/site1")), first);
+}
+
+BOOST_AUTO_TEST_CASE(LatestData)
+{
+  CtMemory storage;
+  auto makeData = [this] (const Name& name) {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    return data;
+  };
+  std::vector<Data> versions;
+  for (uint64_t version : {1, 2, 10}) {
+    versions.push_back(makeData(Name("/ndn/site1/abc").appendVersion(version)));
+    storage.addData(versions.back());
+  }
+  auto sibling = makeData(Name("/ndn/site1/abd").appendVersion(100));
+  storage.addData(sibling);
+
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[2]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(versions[0].getName()), versions[0]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name()), sibling);
+  BOOST_CHECK(!storage.findLatestData(Name("/ndn/site1/ab")));
+
+  storage.deleteData(versions[2].getName());
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[1]);
+  storage.deleteData(versions[1].getName());
+  storage.deleteData(versions[0].getName());
+  BOOST_CHECK(!storage.findLatestData(Name("/ndn/site1/abc")));
+}
+
+BOOST_AUTO_TEST_CASE(PrecedingName)
+{
+  CtMemory storage;
+  std::vector<Name> names;
+  for (const auto& name : {"/ndn/site1/abc", "/ndn/site1/abe", "/ndn/site2/abc"}) {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    storage.addData(data);
+    names.push_back(data.getName());
+  }
+
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abd"), names[0]);
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abe"), names[0]);
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site2"), names[1]);
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site1", "/ndn/site1/abc"));
+  // names of other prefixes do not count
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site2", "/ndn/site2/abb"));
+}
+
+BOOST_AUTO_TEST_CASE(Snapshot)
+{
+  CtMemory storage;
+  std::vector<Data> records;
+  for (int i = 0; i < 3; i++) {
+    records.emplace_back(Name("/ndn/site1").appendNumber(i));
+    m_keyChain.sign(records.back(), ndn::signingWithSha256());
+    storage.addData(records.back());
+  }
+
+  auto snapshot = storage.getSnapshot();
+  storage.deleteData(records[0].getName());
+  Data added("/ndn/site1/abc");
+  m_keyChain.sign(added, ndn::signingWithSha256());
+  storage.addData(added);
+
+  // the snapshot keeps the records of the time it was taken
+  BOOST_CHECK_EQUAL(snapshot.size(), 3);
+  BOOST_CHECK_EQUAL(*snapshot.find(records[0].getName()), records[0]);
+  BOOST_CHECK(snapshot.find(added.getName()) == nullptr);
+  BOOST_CHECK(storage.findData(records[0].getName()) == nullptr);
+  BOOST_CHECK_EQUAL(*storage.findData(added.getName()), added);
+}
+
+BOOST_AUTO_TEST_CASE(Durability)
+{
+  auto dir = boost::filesystem::path(TMP_TESTS_PATH) / "CtMemoryTest";
+  boost::filesystem::remove_all(dir);
+  auto cert1 = addIdentity(Name("/ndn/site1")).getDefaultKey().getDefaultCertificate();
+  auto cert2 = addIdentity(Name("/ndn/site2")).getDefaultKey().getDefaultCertificate();
+
+  {
+    CtMemory storage(Name(), dir.string());
+    storage.addData(cert1);
+    storage.addData(cert2);
+    storage.deleteData(cert2.getName());
+    // nothing reaches the log before commit
+    BOOST_CHECK_EQUAL(storage.m_walSize, 0);
+    storage.commit();
+    BOOST_CHECK_GT(storage.m_walSize, 0);
+  }
+
+  // an incomplete block at the tail of the log is dropped
+  {
+    std::ofstream wal((dir / "wal").string(), std::ios::binary | std::ios::app);
+    wal.write("\x06\xfd\x01", 3);
+  }
+  {
+    CtMemory storage(Name(), dir.string());
+    BOOST_CHECK_EQUAL(*storage.findData(cert1.getName()), cert1);
+    BOOST_CHECK(storage.findData(cert2.getName()) == nullptr);
+
+    // a commit past the threshold writes a snapshot and empties the log
+    storage.m_snapshotWalSize = 1;
+    storage.addData(cert2);
+    storage.commit();
+    BOOST_CHECK_EQUAL(storage.m_walSize, 0);
+    BOOST_CHECK_GT(storage.m_snapshotSize, 0);
+  }
+  {
+    CtMemory storage(Name(), dir.string());
+    BOOST_CHECK_EQUAL(*storage.findData(cert1.getName()), cert1);
+    BOOST_CHECK_EQUAL(*storage.findData(cert2.getName()), cert2);
+  }
+  boost::filesystem::remove_all(dir);
 }
 
 BOOST_AUTO_TEST_SUITE_END() // TestCtMemoryV2
@@ -2,6 +2,7 @@
 #include "test-common.hpp"
 #include "revoker.hpp"
 #include "checker.hpp"
+#include "storage/ct-memory.hpp"
 
 namespace ndnrevoke {
 namespace tests {
@@ -10,17 +11,28 @@ using namespace ct;
 using ndn::util::DummyClientFace;
 using ndn::security::verifySignature;
 
+class FailingCommitStorage : public CtMemory
+{
+public:
+  void
+  commit() override
+  {
+    NDN_THROW(std::runtime_error("Disk is full"));
+  }
+};
+
 BOOST_FIXTURE_TEST_SUITE(TestCtModule, IdentityManagementTimeFixture)
 
 BOOST_AUTO_TEST_CASE(Initialization)
 {
+  addIdentity(Name("/ndn"));
   DummyClientFace face(io, m_keyChain, {true, true});
   CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
   BOOST_CHECK_EQUAL(ct.getCtConf().ctPrefix, Name("/ndn"));
 
   advanceClocks(time::milliseconds(20), 60);
   BOOST_CHECK_EQUAL(ct.m_handle.m_registeredPrefixHandles.size(), 1); // removed local discovery registration
-  BOOST_CHECK_EQUAL(ct.m_handle.m_interestFilterHandles.size(), 2);
+  BOOST_CHECK_EQUAL(ct.m_handle.m_interestFilterHandles.size(), 3); // record zones and the index
 }
 
 BOOST_AUTO_TEST_CASE(HandleQueryAndRecord)
@@ -41,11 +53,11 @@ BOOST_AUTO_TEST_CASE(HandleQueryAndRecord)
   revoker::Revoker revoker(m_keyChain);
   checker::Checker checker(face, validator);
 
-  ct.m_storage->addData(cert2);
+  ct.storeData(cert2);
   advanceClocks(time::milliseconds(20), 60);
   auto record = revoker.revokeAsOwner(cert2, tlv::ReasonCode::KEY_COMPROMISE, 
                                       time::toUnixTimestamp(time::system_clock::now()), 1_s);
-  ct.m_storage->addData(*record);
+  ct.storeData(*record);
   checker.doOwnerCheck(Name("/ndn/LEDGER"), cert2, nullptr, 
     [record] (auto&&, auto& i) {
       BOOST_CHECK_EQUAL(i.getName(), record->getName());
@@ -86,6 +98,540 @@ BOOST_AUTO_TEST_CASE(HandleQueryAndNack)
   advanceClocks(time::milliseconds(200), 600);
 }
 
+BOOST_AUTO_TEST_CASE(BatchedNack)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto cert1 = addSubCertificate(Name("/ndn/site1/abc"), identity).getDefaultKey().getDefaultCertificate();
+  auto cert2 = addSubCertificate(Name("/ndn/site2/abc"), identity).getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-4", "ct-storage-memory");
+  DummyClientFace checkerFace(io, m_keyChain, {true, true});
+  checkerFace.linkTo(face);
+  ndn::ValidatorConfig validator{checkerFace};
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+  checker::Checker checker(checkerFace, validator);
+  advanceClocks(time::milliseconds(20), 60);
+
+  int nValid = 0;
+  for (const auto& cert : {cert1, cert2}) {
+    checker.doOwnerCheck(Name("/ndn/LEDGER"), cert,
+      [&nValid, cert] (auto&&, auto& i) {
+        BOOST_CHECK_EQUAL(i.getCertName(), cert.getName());
+        nValid++;
+      },
+      [] (auto&&...) { BOOST_ERROR("Unexpected revocation"); },
+      [] (auto&&...) { BOOST_ERROR("Unexpected failure"); }
+    );
+  }
+  advanceClocks(time::milliseconds(20), 60);
+  BOOST_CHECK_EQUAL(nValid, 2);
+  // both nacks share one signed root
+  BOOST_CHECK_EQUAL(ct.m_batchRoots.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(RangeNack)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto cert1 = addSubCertificate(Name("/ndn/site1/abc"), identity).getDefaultKey().getDefaultCertificate();
+  auto cert2 = addSubCertificate(Name("/ndn/site1/abd"), identity).getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-5", "ct-storage-memory");
+  Data stored("/ndn/site1/zzz");
+  m_keyChain.sign(stored, ndn::signingWithSha256());
+  ct.storeData(stored);
+  DummyClientFace checkerFace(io, m_keyChain, {true, true});
+  checkerFace.linkTo(face);
+  ndn::ValidatorConfig validator{checkerFace};
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+  checker::Checker checker(checkerFace, validator);
+  advanceClocks(time::milliseconds(20), 60);
+
+  int nValid = 0;
+  auto check = [&] (const Certificate& cert) {
+    checker.doOwnerCheck(Name("/ndn/LEDGER"), cert,
+      [&nValid] (auto&&...) { nValid++; },
+      [] (auto&&...) { BOOST_ERROR("Unexpected revocation"); },
+      [] (auto&&...) { BOOST_ERROR("Unexpected failure"); }
+    );
+    advanceClocks(time::milliseconds(20), 60);
+  };
+  check(cert1);
+  BOOST_CHECK_EQUAL(nValid, 1);
+  BOOST_REQUIRE_EQUAL(ct.m_ranges->size(), 1);
+  auto range = ct.m_ranges->find(Name("/ndn/site1"));
+  BOOST_REQUIRE(range != nullptr);
+  BOOST_CHECK(!range->statement.lower);
+  BOOST_CHECK_EQUAL(*range->statement.upper, stored.getName());
+
+  // the second certificate falls in the same range, the checker answers it locally
+  size_t nSent = checkerFace.sentInterests.size();
+  check(cert2);
+  BOOST_CHECK_EQUAL(nValid, 2);
+  BOOST_CHECK_EQUAL(checkerFace.sentInterests.size(), nSent);
+
+  // a record stored in the range invalidates its statement
+  Data splitter("/ndn/site1/abd");
+  m_keyChain.sign(splitter, ndn::signingWithSha256());
+  ct.storeData(splitter);
+  BOOST_CHECK_EQUAL(ct.m_ranges->size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(StaleRangeNack)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto cert = addSubCertificate(Name("/ndn/site1/abc"), identity).getDefaultKey().getDefaultCertificate();
+
+  // a statement signed an hour ago, fresh for 10 seconds
+  auto signedAt = time::toUnixTimestamp(time::system_clock::now() - 1_h);
+  Data statement(Name("/ndn/LEDGER/RANGE").appendVersion(signedAt.count()));
+  statement.setContent(nack::encodeRangeStatement({"/ndn/site1", nullopt, nullopt}));
+  statement.setFreshnessPeriod(10_s);
+  m_keyChain.sign(statement, ndn::security::signingByIdentity(identity));
+
+  DummyClientFace checkerFace(io, m_keyChain, {true, true});
+  checkerFace.onSendInterest.connect([&] (const Interest& interest) {
+    if (!Name("/ndn/LEDGER").isPrefixOf(interest.getName())) {
+      return;
+    }
+    nack::Nack nack;
+    auto data = nack.prepareData(interest.getName(), signedAt);
+    data->setContent(nack::encodeRangeNack(statement));
+    m_keyChain.sign(*data, ndn::signingWithSha256());
+    io.post([&checkerFace, data] { checkerFace.receive(*data); });
+  });
+  ndn::ValidatorConfig validator{checkerFace};
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+  checker::Checker checker(checkerFace, validator);
+
+  int nFailed = 0;
+  checker.doOwnerCheck(Name("/ndn/LEDGER"), cert,
+    [] (auto&&...) { BOOST_ERROR("Unexpected valid"); },
+    [] (auto&&...) { BOOST_ERROR("Unexpected revocation"); },
+    [&nFailed] (auto&&...) { nFailed++; }
+  );
+  advanceClocks(time::milliseconds(20), 60);
+  BOOST_CHECK_EQUAL(nFailed, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ForgedRangeNack)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto site = addSubCertificate(Name("/ndn/site1"), identity);
+  auto cert = addSubCertificate(Name("/ndn/site1/abc"), site).getDefaultKey().getDefaultCertificate();
+
+  // statements of a site covering its own zone: under its own prefix, and under the CT prefix
+  auto signedAt = time::toUnixTimestamp(time::system_clock::now());
+  for (const auto& prefix : {"/ndn/site1/LEDGER/RANGE", "/ndn/LEDGER/RANGE"}) {
+    Data statement(Name(prefix).appendVersion(signedAt.count()));
+    statement.setContent(nack::encodeRangeStatement({"/ndn/site1", nullopt, nullopt}));
+    statement.setFreshnessPeriod(10_s);
+    m_keyChain.sign(statement, ndn::security::signingByIdentity(site));
+
+    DummyClientFace checkerFace(io, m_keyChain, {true, true});
+    checkerFace.onSendInterest.connect([&] (const Interest& interest) {
+      if (!Name("/ndn/site1/abc").isPrefixOf(interest.getName())) {
+        return;
+      }
+      nack::Nack nack;
+      auto data = nack.prepareData(interest.getName(), signedAt);
+      data->setContent(nack::encodeRangeNack(statement));
+      m_keyChain.sign(*data, ndn::signingWithSha256());
+      io.post([&checkerFace, data] { checkerFace.receive(*data); });
+    });
+    ndn::ValidatorConfig validator{checkerFace};
+    validator.load("tests/unit-tests/config-files/trust-schema.conf");
+    checker::Checker checker(checkerFace, validator);
+
+    int nFailed = 0;
+    checker.doOwnerCheck(Name("/ndn/LEDGER"), cert,
+      [] (auto&&...) { BOOST_ERROR("Unexpected valid"); },
+      [] (auto&&...) { BOOST_ERROR("Unexpected revocation"); },
+      [&nFailed] (auto&&...) { nFailed++; }
+    );
+    advanceClocks(time::milliseconds(20), 60);
+    BOOST_CHECK_EQUAL(nFailed, 1);
+    BOOST_CHECK_EQUAL(checker.m_ranges.size(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NackSigning)
+{
+  addIdentity(Name("/ndn"));
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-6", "ct-storage-memory");
+  auto nack = ct.makeNack("/ndn/site1/abc");
+  BOOST_CHECK_EQUAL(nack->getSignatureType(), ndn::tlv::DigestSha256);
+}
+
+BOOST_AUTO_TEST_CASE(StatementSigning)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto cert = addSubCertificate(Name("/ndn/site1/abc"), identity).getDefaultKey().getDefaultCertificate();
+
+  // nacks signed with HMAC and with a digest, batch roots and range statements still
+  // pass the trust schema
+  for (const auto& config : {"config-ct-7", "config-ct-8"}) {
+    DummyClientFace face(io, m_keyChain, {true, true});
+    CtModule ct(face, m_keyChain, std::string("tests/unit-tests/config-files/") + config, "ct-storage-memory");
+    DummyClientFace checkerFace(io, m_keyChain, {true, true});
+    checkerFace.linkTo(face);
+    ndn::ValidatorConfig validator{checkerFace};
+    validator.load("tests/unit-tests/config-files/trust-schema.conf");
+    checker::Checker checker(checkerFace, validator);
+    advanceClocks(time::milliseconds(20), 60);
+
+    int nValid = 0;
+    checker.doOwnerCheck(Name("/ndn/LEDGER"), cert,
+      [&nValid] (auto&&...) { nValid++; },
+      [] (auto&&...) { BOOST_ERROR("Unexpected revocation"); },
+      [] (auto&&...) { BOOST_ERROR("Unexpected failure"); }
+    );
+    advanceClocks(time::milliseconds(20), 60);
+    BOOST_CHECK_EQUAL(nValid, 1);
+    BOOST_CHECK_EQUAL(ct.m_statementSigner.getSigningInfo().getSignerType(),
+                      ndn::security::SigningInfo::SIGNER_TYPE_KEY);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ForeignBatchRoot)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto cert = addSubCertificate(Name("/ndn/site1/abc"), identity).getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-7", "ct-storage-memory");
+  DummyClientFace checkerFace(io, m_keyChain, {true, true});
+  checkerFace.linkTo(face);
+  ndn::ValidatorConfig validator{checkerFace};
+  validator.load("tests/unit-tests/config-files/trust-schema.conf");
+  checker::Checker checker(checkerFace, validator);
+  advanceClocks(time::milliseconds(20), 60);
+
+  // the batch root of /ndn cannot vouch for a nack of another CT
+  int nFailures = 0;
+  checker.doOwnerCheck(Name("/other/LEDGER"), cert,
+    [] (auto&&...) { BOOST_ERROR("Unexpected validation"); },
+    [] (auto&&...) { BOOST_ERROR("Unexpected revocation"); },
+    [&nFailures] (auto&&...) { nFailures++; }
+  );
+  advanceClocks(time::milliseconds(20), 60);
+  BOOST_CHECK_EQUAL(nFailures, 1);
+  for (const auto& interest : checkerFace.sentInterests) {
+    BOOST_CHECK(!Name("/ndn/LEDGER/NACK-BATCH").isPrefixOf(interest.getName()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentSubmissions)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto issuer = addSubCertificate(Name("/ndn/site1/abc"), identity);
+  auto issuerCert = issuer.getDefaultKey().getDefaultCertificate();
+  std::vector<Certificate> certs;
+  for (int i = 0; i < 20; i++) {
+    auto device = addSubCertificate(Name("/ndn/site1/abc").appendNumber(i), issuer);
+    certs.push_back(device.getDefaultKey().getDefaultCertificate());
+  }
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  advanceClocks(time::milliseconds(20), 60);
+
+  // the issuer certificate takes 100ms to be fetched
+  ndn::Scheduler scheduler(io);
+  face.onSendInterest.connect([&] (const Interest& interest) {
+    if (interest.getName().isPrefixOf(issuerCert.getName())) {
+      scheduler.schedule(100_ms, [&] { face.receive(issuerCert); });
+    }
+  });
+
+  std::vector<AppendStatus> statuses;
+  for (const auto& cert : certs) {
+    ct.onDataSubmission("/client/msg/append/1", cert, [&statuses] (AppendStatus status) { statuses.push_back(status); });
+  }
+  BOOST_CHECK(statuses.empty());
+  // validations wait for the fetch together, not one after another
+  advanceClocks(time::milliseconds(10), 15);
+  BOOST_REQUIRE_EQUAL(statuses.size(), certs.size());
+  BOOST_CHECK(std::all_of(statuses.begin(), statuses.end(),
+                          [] (auto status) { return status == AppendStatus::SUCCESS; }));
+  BOOST_CHECK_EQUAL(ct.getZoneUsage().at("/ndn/site1").nRecords, certs.size());
+}
+
+BOOST_AUTO_TEST_CASE(OrderedSubmissions)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  auto issuer = addSubCertificate(Name("/ndn/site1/abc"), identity);
+  auto issuerCert = issuer.getDefaultKey().getDefaultCertificate();
+  auto slow = addSubCertificate(Name("/ndn/site1/abc/slow"), issuer).getDefaultKey().getDefaultCertificate();
+  auto fast = addSubCertificate(Name("/ndn/site1/fast"), identity).getDefaultKey().getDefaultCertificate();
+  auto other = addSubCertificate(Name("/ndn/site1/other"), identity).getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  advanceClocks(time::milliseconds(20), 60);
+
+  std::vector<Name> done;
+  ct.onDataSubmission("/client/msg/append/1", slow, [&] (auto) { done.push_back(slow.getName()); });
+  ct.onDataSubmission("/client/msg/append/1", fast, [&] (auto) { done.push_back(fast.getName()); });
+  ct.onDataSubmission("/client/msg/append/2", other, [&] (auto) { done.push_back(other.getName()); });
+  // fast is validated, but waits for slow to be stored first; another submission does not
+  advanceClocks(time::milliseconds(10), 5);
+  BOOST_CHECK(done == (std::vector<Name>{other.getName()}));
+  BOOST_CHECK(ct.getCtStorage()->findData(fast.getName()) == nullptr);
+
+  face.receive(issuerCert);
+  advanceClocks(time::milliseconds(10), 5);
+  BOOST_CHECK(done == (std::vector<Name>{other.getName(), slow.getName(), fast.getName()}));
+  BOOST_CHECK(ct.m_pendingUpdates.empty());
+}
+
+BOOST_AUTO_TEST_CASE(NegativeFilter)
+{
+  addIdentity(Name("/ndn"));
+  auto identity = addIdentity(Name("/ndn/site1/abc"));
+  auto cert = identity.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  BOOST_CHECK_EQUAL(ct.m_zoneFilters.size(), 2);
+  BOOST_CHECK(ct.isDefiniteMiss(cert.getName()));
+
+  ct.storeData(cert);
+  BOOST_CHECK(!ct.isDefiniteMiss(cert.getName()));
+  // prefixes are covered for CanBePrefix queries
+  BOOST_CHECK(!ct.isDefiniteMiss(cert.getName().getPrefix(-1)));
+  // names outside of the record zones are never filtered
+  BOOST_CHECK(!ct.isDefiniteMiss(Name("/other/name")));
+}
+
+BOOST_AUTO_TEST_CASE(CachedNack)
+{
+  addIdentity(Name("/ndn"));
+  auto identity = addIdentity(Name("/ndn/site1/abc"));
+  auto cert = identity.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  advanceClocks(time::milliseconds(20), 60);
+
+  Interest query(cert.getName());
+  query.setForwardingHint({Name("/ndn/LEDGER")});
+  ct.onQuery(query);
+  ct.onQuery(query);
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  // the second miss is answered with the same nack, fresh only for the rest of its lifetime
+  BOOST_CHECK_EQUAL(face.sentData[0].getName(), face.sentData[1].getName());
+  BOOST_CHECK_LT(face.sentData[1].getFreshnessPeriod(), face.sentData[0].getFreshnessPeriod());
+
+  // storing the record invalidates the nack
+  ct.storeData(cert);
+  ct.onQuery(query);
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 3);
+  BOOST_CHECK_EQUAL(face.sentData[2], cert);
+}
+
+BOOST_AUTO_TEST_CASE(IndexQuery)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  auto identity2 = addSubCertificate(Name("/ndn/site1/abc"), identity);
+  auto cert2 = identity2.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  advanceClocks(time::milliseconds(20), 60);
+  revoker::Revoker revoker(m_keyChain);
+  auto record = revoker.revokeAsOwner(cert2, tlv::ReasonCode::KEY_COMPROMISE);
+  ct.storeData(*record);
+
+  auto keyHash = Sha256::computeDigest(cert2.getPublicKey());
+  Interest query(Name("/ndn/LEDGER/INDEX/PUBKEY-HASH").append(Name::Component(*keyHash)));
+  face.receive(query);
+  advanceClocks(time::milliseconds(20), 10);
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  Block content = face.sentData[0].getContent();
+  content.parse();
+  BOOST_REQUIRE_EQUAL(content.elements().size(), 1);
+  BOOST_CHECK_EQUAL(Name(content.elements()[0]), record->getName());
+
+  // removed records leave the index
+  ct.removeData(record->getName());
+  face.receive(Interest(query.getName()));
+  advanceClocks(time::milliseconds(20), 10);
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  BOOST_CHECK_EQUAL(face.sentData[1].getContentType(), ndn::tlv::ContentType_Nack);
+}
+
+BOOST_AUTO_TEST_CASE(IndexQueryPages)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  advanceClocks(time::milliseconds(20), 60);
+
+  // more records of one issuer than fit in a reply
+  revoker::Revoker revoker(m_keyChain);
+  std::set<Name> records;
+  Name::Component issuer;
+  for (size_t i = 0; i <= CtModule::MAX_INDEX_RESULTS; i++) {
+    auto cert = addSubCertificate(Name("/ndn/site1/abc").appendNumber(i), identity).getDefaultKey().getDefaultCertificate();
+    auto record = revoker.revokeAsOwner(cert, tlv::ReasonCode::KEY_COMPROMISE);
+    ct.storeData(*record);
+    records.insert(record->getName());
+    issuer = cert.getIssuerId();
+  }
+
+  std::set<Name> found;
+  optional<Name> next = Name("/ndn/LEDGER/INDEX/ISSUER").append(issuer);
+  size_t nPages = 0;
+  while (next) {
+    face.receive(Interest(*next));
+    advanceClocks(time::milliseconds(20), 10);
+    BOOST_REQUIRE_EQUAL(face.sentData.size(), ++nPages);
+    Block content = face.sentData.back().getContent();
+    content.parse();
+    next = nullopt;
+    for (const auto& element : content.elements()) {
+      if (element.type() == tlv::IndexNextPage) {
+        next = Name(element.blockFromValue());
+      }
+      else {
+        found.insert(Name(element));
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(nPages, 2);
+  BOOST_CHECK(found == records);
+}
+
+BOOST_AUTO_TEST_CASE(ZoneQuota)
+{
+  addIdentity(Name("/ndn"));
+  auto identity = addIdentity(Name("/ndn/site1/abc"));
+  auto cert = identity.getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-3", "ct-storage-memory");
+  BOOST_CHECK(!ct.isOverQuota(cert));
+  ct.storeData(cert);
+  const auto& usage = ct.getZoneUsage().at(Name("/ndn/site1"));
+  BOOST_CHECK_EQUAL(usage.nRecords, 1);
+  BOOST_CHECK_EQUAL(usage.nBytes, cert.wireEncode().size());
+  BOOST_CHECK_EQUAL(ct.getZoneUsage().at(Name("/ndn/site2")).nRecords, 0);
+
+  // the quota of /ndn/site1 is 2000 bytes
+  Data filler(Name("/ndn/site1/filler"));
+  filler.setContent(std::vector<uint8_t>(2000 - cert.wireEncode().size() - 200, 0));
+  m_keyChain.sign(filler, ndn::signingWithSha256());
+  BOOST_REQUIRE_LT(usage.nBytes + filler.wireEncode().size(), 2000);
+  BOOST_CHECK(!ct.isOverQuota(filler));
+  ct.storeData(filler);
+  BOOST_CHECK(ct.isOverQuota(cert));
+
+  ct.removeData(filler.getName());
+  BOOST_CHECK_EQUAL(usage.nRecords, 1);
+  BOOST_CHECK_EQUAL(usage.nBytes, cert.wireEncode().size());
+}
+
+BOOST_AUTO_TEST_CASE(LoadRecords)
+{
+  addIdentity(Name("/ndn"));
+  std::vector<Certificate> certs;
+  for (const auto& name : {"/ndn/site1/a", "/ndn/site1/b", "/ndn/site1/c"}) {
+    certs.push_back(addIdentity(Name(name)).getDefaultKey().getDefaultCertificate());
+  }
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  BOOST_CHECK(!ct.isLoadingRecords());
+
+  // records stored before a restart are loaded after it, in the background
+  ct.m_storage->addData(certs[0]);
+  ct.m_storage->addData(certs[2]);
+  ct.initRecords();
+  BOOST_CHECK(ct.isLoadingRecords());
+  BOOST_CHECK_EQUAL(ct.getZoneUsage().at(Name("/ndn/site1")).nRecords, 0);
+
+  // a submission waits for loading, its record is then counted once
+  std::vector<AppendStatus> statuses;
+  auto update = std::make_shared<CtModule::PendingUpdate>();
+  update->done = [&statuses] (AppendStatus status) { statuses.push_back(status); };
+  update->isValidated = true;
+  update->data = certs[1];
+  ct.m_pendingUpdates["/client/msg/append/1"].push_back(update);
+  ct.applyUpdates("/client/msg/append/1");
+  BOOST_CHECK(statuses.empty());
+
+  advanceClocks(1_ms, 10);
+  BOOST_CHECK(!ct.isLoadingRecords());
+  BOOST_REQUIRE_EQUAL(statuses.size(), 1);
+  BOOST_CHECK(statuses.front() == AppendStatus::SUCCESS);
+  BOOST_CHECK_EQUAL(ct.getZoneUsage().at(Name("/ndn/site1")).nRecords, certs.size());
+  BOOST_CHECK_EQUAL(ct.m_expiryWheel.size(), certs.size());
+}
+
+BOOST_AUTO_TEST_CASE(FailedCommit)
+{
+  addIdentity(Name("/ndn"));
+  auto cert = addIdentity(Name("/ndn/site1/abc")).getDefaultKey().getDefaultCertificate();
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  ct.m_storage = std::make_unique<FailingCommitStorage>();
+  BOOST_CHECK(ct.storeSubmission(cert) == AppendStatus::SUCCESS);
+  BOOST_CHECK(!ct.isDefiniteMiss(cert.getName()));
+
+  // the record is not served once its submitter is told it failed
+  BOOST_CHECK(!ct.onSubmissionCommit());
+  BOOST_CHECK(ct.m_storage->findData(cert.getName()) == nullptr);
+  BOOST_CHECK(ct.isDefiniteMiss(cert.getName()));
+  BOOST_CHECK_EQUAL(ct.getZoneUsage().at(Name("/ndn/site1")).nRecords, 0);
+  BOOST_CHECK(ct.m_uncommittedRecords.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Expiry)
+{
+  addIdentity(Name("/ndn"));
+  auto identity = addIdentity(Name("/ndn/site1/abc"));
+  Certificate cert(identity.getDefaultKey().getDefaultCertificate());
+  ndn::SignatureInfo info;
+  info.setValidityPeriod(ndn::security::ValidityPeriod(time::system_clock::now(),
+                                                       time::system_clock::now() + 10_s));
+  m_keyChain.sign(cert, ndn::security::signingByIdentity(identity).setSignatureInfo(info));
+
+  DummyClientFace face(io, m_keyChain, {true, true});
+  CtModule ct(face, m_keyChain, "tests/unit-tests/config-files/config-ct-1", "ct-storage-memory");
+  ct.storeData(cert);
+  BOOST_CHECK_EQUAL(ct.m_expiryWheel.size(), 1);
+
+  advanceClocks(1_s, 5);
+  BOOST_CHECK(ct.m_storage->findData(cert.getName()) != nullptr);
+
+  // the certificate is removed once its validity period is over
+  advanceClocks(1_s, 10);
+  BOOST_CHECK(ct.m_storage->findData(cert.getName()) == nullptr);
+  BOOST_CHECK(ct.isDefiniteMiss(cert.getName()));
+  BOOST_CHECK_EQUAL(ct.m_expiryWheel.size(), 0);
+
+  // without the certificate, its revocation is kept whatever the retention
+  ct.m_config.recordRetention = 1_s;
+  revoker::Revoker revoker(m_keyChain);
+  auto record = revoker.revokeAsOwner(cert, tlv::ReasonCode::KEY_COMPROMISE);
+  ct.storeData(*record);
+  BOOST_CHECK_EQUAL(ct.m_expiryWheel.size(), 0);
+  advanceClocks(1_s, 5);
+  BOOST_CHECK(ct.m_storage->findData(record->getName()) != nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestCtModule
 
 } // namespace tests
@@ -0,0 +1,237 @@
+#include "storage/ct-segment.hpp"
+#include "test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+class CtSegmentFixture : public IdentityManagementFixture
+{
+public:
+  CtSegmentFixture()
+  {
+    boost::filesystem::path dir(TMP_TESTS_PATH);
+    dir /= "CtSegmentTest";
+    boost::filesystem::remove_all(dir);
+    segmentDir = dir.string();
+  }
+
+  ~CtSegmentFixture()
+  {
+    boost::filesystem::remove_all(segmentDir);
+  }
+
+  std::vector<Certificate>
+  makeCertificates(size_t n)
+  {
+    std::vector<Certificate> certs;
+    for (size_t i = 0; i < n; i++) {
+      auto identity = addIdentity(Name("/ndn/site" + std::to_string(i)));
+      certs.push_back(identity.getDefaultKey().getDefaultCertificate());
+    }
+    return certs;
+  }
+
+public:
+  std::string segmentDir;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCtSegment, CtSegmentFixture)
+
+BOOST_AUTO_TEST_CASE(BasicOps)
+{
+  CtSegment storage(Name(), segmentDir);
+  auto cert1 = makeCertificates(1).front();
+
+  // add operation
+  BOOST_CHECK_NO_THROW(storage.addData(cert1));
+  BOOST_CHECK_THROW(storage.addData(cert1), std::runtime_error);
+
+  // get operation
+  Data result;
+  BOOST_CHECK_NO_THROW(result = storage.getData(cert1.getName()));
+  BOOST_CHECK_EQUAL(cert1, result);
+
+  // delete operation
+  BOOST_CHECK_NO_THROW(storage.deleteData(cert1.getName()));
+  BOOST_CHECK_THROW(storage.getData(cert1.getName()), std::runtime_error);
+  BOOST_CHECK_THROW(storage.deleteData(cert1.getName()), std::runtime_error);
+
+  // re-add after delete
+  BOOST_CHECK_NO_THROW(storage.addData(cert1));
+  BOOST_CHECK_EQUAL(storage.getData(cert1.getName()), cert1);
+}
+
+BOOST_AUTO_TEST_CASE(SealAndReopen)
+{
+  auto certs = makeCertificates(3);
+  {
+    CtSegment storage(Name(), segmentDir);
+    storage.m_segmentSizeLimit = 1;
+    storage.addData(certs[0]);
+    storage.addData(certs[1]);
+    BOOST_CHECK_EQUAL(storage.m_segments.size(), 2);
+    storage.deleteData(certs[0].getName());
+    storage.m_segmentSizeLimit = CtSegment::SEGMENT_SIZE_LIMIT;
+    storage.addData(certs[2]);
+  }
+
+  // sealed segments are mapped, the active one is replayed
+  CtSegment storage(Name(), segmentDir);
+  BOOST_CHECK_EQUAL(storage.m_segments.size(), 3);
+  BOOST_CHECK_EQUAL(storage.m_activeEntries.size(), 1);
+  BOOST_CHECK_THROW(storage.getData(certs[0].getName()), std::runtime_error);
+  BOOST_CHECK_EQUAL(storage.getData(certs[1].getName()), certs[1]);
+  BOOST_CHECK_EQUAL(storage.getData(certs[2].getName()), certs[2]);
+}
+
+BOOST_AUTO_TEST_CASE(Compaction)
+{
+  auto certs = makeCertificates(4);
+  {
+    CtSegment storage(Name(), segmentDir);
+    storage.m_segmentSizeLimit = 1;
+    storage.m_compactionThreshold = 4;
+    storage.addData(certs[0]);
+    storage.addData(certs[1]);
+    storage.deleteData(certs[0].getName());
+    storage.addData(certs[2]);
+    storage.m_compaction.join();
+    BOOST_CHECK_EQUAL(storage.m_segments.size(), 1);
+
+    BOOST_CHECK_THROW(storage.getData(certs[0].getName()), std::runtime_error);
+    BOOST_CHECK_EQUAL(storage.getData(certs[1].getName()), certs[1]);
+    BOOST_CHECK_EQUAL(storage.getData(certs[2].getName()), certs[2]);
+    storage.m_segmentSizeLimit = CtSegment::SEGMENT_SIZE_LIMIT;
+    storage.addData(certs[3]);
+  }
+
+  CtSegment storage(Name(), segmentDir);
+  BOOST_CHECK_EQUAL(storage.m_segments.size(), 1);
+  BOOST_CHECK_THROW(storage.getData(certs[0].getName()), std::runtime_error);
+  BOOST_CHECK_EQUAL(storage.getData(certs[1].getName()), certs[1]);
+  BOOST_CHECK_EQUAL(storage.getData(certs[2].getName()), certs[2]);
+  BOOST_CHECK_EQUAL(storage.getData(certs[3].getName()), certs[3]);
+}
+
+BOOST_AUTO_TEST_CASE(SizeRatioCompaction)
+{
+  auto certs = makeCertificates(7);
+  CtSegment storage(Name(), segmentDir);
+  storage.m_segmentSizeLimit = 1;
+  storage.m_compactionThreshold = 4;
+  for (size_t i = 0; i < 4; i++) {
+    storage.addData(certs[i]);
+  }
+  storage.m_compaction.join();
+  BOOST_REQUIRE_EQUAL(storage.m_segments.size(), 1);
+  auto merged = storage.m_segments.front();
+
+  // the merged segment is larger than the newer segments together, so it is left alone
+  // and the tombstone is kept to hide the record in it
+  storage.deleteData(certs[0].getName());
+  for (size_t i = 4; i < 7; i++) {
+    storage.addData(certs[i]);
+  }
+  storage.m_compaction.join();
+  BOOST_REQUIRE_EQUAL(storage.m_segments.size(), 2);
+  BOOST_CHECK(storage.m_segments.front() == merged);
+  BOOST_CHECK_THROW(storage.getData(certs[0].getName()), std::runtime_error);
+  for (size_t i = 1; i < 7; i++) {
+    BOOST_CHECK_EQUAL(storage.getData(certs[i].getName()), certs[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(VisitAndWrite)
+{
+  auto certs = makeCertificates(4);
+  CtSegment storage(Name(), segmentDir);
+  storage.m_segmentSizeLimit = 1;
+  storage.m_compactionThreshold = 100;
+  storage.addData(certs[0]);
+  storage.addData(certs[1]);
+
+  // writing from the visitor seals a segment, which must not deadlock
+  size_t nVisited = 0;
+  storage.visitNames(Name("/ndn"), [&] (const Name&) {
+    storage.addData(certs[2 + nVisited++]);
+  });
+  BOOST_CHECK_EQUAL(nVisited, 2);
+  BOOST_CHECK_EQUAL(storage.getData(certs[3].getName()), certs[3]);
+}
+
+BOOST_AUTO_TEST_CASE(LatestData)
+{
+  CtSegment storage(Name(), segmentDir);
+  // every operation lands in its own sealed segment
+  storage.m_segmentSizeLimit = 1;
+  storage.m_compactionThreshold = 100;
+
+  auto makeData = [this] (const Name& name) {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    return data;
+  };
+  std::vector<Data> versions;
+  for (uint64_t version : {1, 2, 10}) {
+    versions.push_back(makeData(Name("/ndn/site1/abc").appendVersion(version)));
+    storage.addData(versions.back());
+  }
+  auto sibling = makeData(Name("/ndn/site1/abd").appendVersion(100));
+  storage.addData(sibling);
+
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[2]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(versions[0].getName()), versions[0]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name()), sibling);
+  BOOST_CHECK(!storage.findLatestData(Name("/ndn/site1/ab")));
+
+  storage.deleteData(versions[2].getName());
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[1]);
+  storage.deleteData(versions[1].getName());
+  storage.deleteData(versions[0].getName());
+  BOOST_CHECK(!storage.findLatestData(Name("/ndn/site1/abc")));
+}
+
+BOOST_AUTO_TEST_CASE(ListNames)
+{
+  CtSegment storage(Name(), segmentDir);
+  storage.m_segmentSizeLimit = 1;
+  storage.m_compactionThreshold = 100;
+
+  auto makeData = [this] (const Name& name) {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    return data;
+  };
+  std::vector<Name> names;
+  for (const auto& name : {"/ndn/site1/abc", "/ndn/site1/abc/v1", "/ndn/site1/abc/v2", "/ndn/site1/abd"}) {
+    storage.addData(makeData(name));
+    names.push_back(name);
+  }
+  // a deleted name is hidden by its newer tombstone, and the last name stays in the active segment
+  storage.deleteData(names[1]);
+  storage.m_segmentSizeLimit = CtSegment::SEGMENT_SIZE_LIMIT;
+  storage.addData(makeData("/ndn/site1/abc/v3"));
+  names.push_back("/ndn/site1/abc/v3");
+  BOOST_REQUIRE_EQUAL(storage.m_activeEntries.size(), 1);
+
+  BOOST_CHECK(storage.listNames("/ndn/site1", nullopt, 2) == (std::vector<Name>{names[0], names[2]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", names[0], 2) == (std::vector<Name>{names[2], names[4]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", names[2], 5) == (std::vector<Name>{names[4], names[3]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", Name("/ndn/site1/abcd"), 5) == (std::vector<Name>{names[3]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", Name("/ndn/site2"), 5).empty());
+
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", names[2]), names[0]);
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", names[3]), names[4]);
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site2"), names[3]);
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site1", names[0]));
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site2", "/ndn/site2/abc"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtSegment
+
+} // namespace tests
+} // namespace ndnrevoke
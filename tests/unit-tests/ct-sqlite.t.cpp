@@ -0,0 +1,158 @@
+#include "storage/ct-sqlite.hpp"
+#include "test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+class CtSqliteFixture : public IdentityManagementFixture
+{
+public:
+  CtSqliteFixture()
+  {
+    boost::filesystem::path dir(TMP_TESTS_PATH);
+    dir /= "CtSqliteTest";
+    boost::filesystem::remove_all(dir);
+    boost::filesystem::create_directories(dir);
+    dbDir = (dir / "ct-test.db").string();
+  }
+
+  ~CtSqliteFixture()
+  {
+    boost::filesystem::remove_all(boost::filesystem::path(TMP_TESTS_PATH) / "CtSqliteTest");
+  }
+
+public:
+  std::string dbDir;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCtSqlite, CtSqliteFixture)
+
+BOOST_AUTO_TEST_CASE(BasicOps)
+{
+  CtSqlite storage(Name(), dbDir);
+
+  auto identity1 = addIdentity(Name("/ndn/site1"));
+  auto key1 = identity1.getDefaultKey();
+  auto cert1 = key1.getDefaultCertificate();
+
+  // add operation
+  BOOST_CHECK_NO_THROW(storage.addData(cert1));
+  BOOST_CHECK_THROW(storage.addData(cert1), std::runtime_error);
+
+  // get operation
+  Data result;
+  BOOST_CHECK_NO_THROW(result = storage.getData(cert1.getName()));
+  BOOST_CHECK_EQUAL(cert1, result);
+
+  // delete operation
+  BOOST_CHECK_NO_THROW(storage.deleteData(cert1.getName()));
+  BOOST_CHECK_THROW(storage.getData(cert1.getName()), std::runtime_error);
+  BOOST_CHECK_THROW(storage.deleteData(cert1.getName()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Persistence)
+{
+  auto identity1 = addIdentity(Name("/ndn/site1"));
+  auto cert1 = identity1.getDefaultKey().getDefaultCertificate();
+
+  {
+    CtSqlite storage(Name(), dbDir);
+    storage.addData(cert1);
+  }
+
+  CtSqlite storage(Name(), dbDir);
+  Data result;
+  BOOST_CHECK_NO_THROW(result = storage.getData(cert1.getName()));
+  BOOST_CHECK_EQUAL(cert1, result);
+}
+
+BOOST_AUTO_TEST_CASE(Commit)
+{
+  auto identity1 = addIdentity(Name("/ndn/site1"));
+  auto cert1 = identity1.getDefaultKey().getDefaultCertificate();
+
+  CtSqlite storage(Name(), dbDir);
+  CtSqlite reader(Name(), dbDir);
+  storage.addData(cert1);
+  BOOST_CHECK(storage.findData(cert1.getName()) != nullptr);
+  // changes are not written out before they are committed
+  BOOST_CHECK(reader.findData(cert1.getName()) == nullptr);
+  storage.commit();
+  BOOST_CHECK(reader.findData(cert1.getName()) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(LatestData)
+{
+  CtSqlite storage(Name(), dbDir);
+  auto makeData = [this] (const Name& name) {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    return data;
+  };
+  std::vector<Data> versions;
+  for (uint64_t version : {1, 2, 10}) {
+    versions.push_back(makeData(Name("/ndn/site1/abc").appendVersion(version)));
+    storage.addData(versions.back());
+  }
+  auto sibling = makeData(Name("/ndn/site1/abd").appendVersion(100));
+  storage.addData(sibling);
+
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[2]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(versions[0].getName()), versions[0]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name()), sibling);
+  BOOST_CHECK(!storage.findLatestData(Name("/ndn/site1/ab")));
+
+  storage.deleteData(versions[2].getName());
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[1]);
+  storage.deleteData(versions[1].getName());
+  storage.deleteData(versions[0].getName());
+  BOOST_CHECK(!storage.findLatestData(Name("/ndn/site1/abc")));
+}
+
+BOOST_AUTO_TEST_CASE(ListNames)
+{
+  CtSqlite storage(Name(), dbDir);
+  std::vector<Name> names;
+  for (uint64_t version : {1, 2, 10}) {
+    Data data(Name("/ndn/site1/abc").appendVersion(version));
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    storage.addData(data);
+    names.push_back(data.getName());
+  }
+  Data sibling(Name("/ndn/site1/abd").appendVersion(1));
+  m_keyChain.sign(sibling, ndn::signingWithSha256());
+  storage.addData(sibling);
+
+  BOOST_CHECK(storage.listNames("/ndn/site1/abc", nullopt, 2) == (std::vector<Name>{names[0], names[1]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1/abc", names[1], 2) == (std::vector<Name>{names[2]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1/abc", names[2], 2).empty());
+  // a position before the prefix starts from the beginning of the prefix
+  BOOST_CHECK(storage.listNames("/ndn/site1/abd", names[2], 2) == (std::vector<Name>{sibling.getName()}));
+}
+
+BOOST_AUTO_TEST_CASE(PrecedingName)
+{
+  CtSqlite storage(Name(), dbDir);
+  std::vector<Name> names;
+  for (const auto& name : {"/ndn/site1/abc", "/ndn/site1/abe", "/ndn/site2/abc"}) {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    storage.addData(data);
+    names.push_back(data.getName());
+  }
+
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abd"), names[0]);
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abe"), names[0]);
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site2"), names[1]);
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site1", "/ndn/site1/abc"));
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site2", "/ndn/site2/abb"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtSqlite
+
+} // namespace tests
+} // namespace ndnrevoke
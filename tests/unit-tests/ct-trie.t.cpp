@@ -0,0 +1,139 @@
+#include "storage/ct-trie.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+class CtTrieFixture : public IdentityManagementFixture
+{
+public:
+  Data
+  makeData(const Name& name)
+  {
+    Data data(name);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    return data;
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestCtTrie, CtTrieFixture)
+
+BOOST_AUTO_TEST_CASE(BasicOps)
+{
+  CtTrie storage;
+  auto cert1 = addIdentity(Name("/ndn/site1")).getDefaultKey().getDefaultCertificate();
+
+  BOOST_CHECK_NO_THROW(storage.addData(cert1));
+  BOOST_CHECK_THROW(storage.addData(cert1), std::runtime_error);
+  BOOST_CHECK_EQUAL(*storage.findData(cert1.getName()), cert1);
+  BOOST_CHECK(storage.findData(cert1.getName().getPrefix(-1)) == nullptr);
+
+  BOOST_CHECK_NO_THROW(storage.deleteData(cert1.getName()));
+  BOOST_CHECK(storage.findData(cert1.getName()) == nullptr);
+  BOOST_CHECK_THROW(storage.deleteData(cert1.getName()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(SharedPrefixes)
+{
+  CtTrie storage;
+  auto record1 = makeData("/ndn/site1/REVOKE/key/1");
+  auto record2 = makeData("/ndn/site1/REVOKE/key/2");
+  auto record3 = makeData("/ndn/site1/REVOKE/1");
+  storage.addData(record1);
+  storage.addData(record2);
+  storage.addData(record3);
+
+  // root, ndn, site1, REVOKE, key, 1, 2, 1
+  BOOST_CHECK_EQUAL(storage.getNNodes(), 8);
+  // the last component of record3 is interned once with the one of record1
+  BOOST_CHECK_EQUAL(storage.getNComponents(), 6);
+
+  std::vector<Name> names;
+  storage.visitNames("/ndn/site1", [&names] (const Name& name) { names.push_back(name); });
+  BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(),
+                                std::vector<Name>({record3.getName(), record1.getName(), record2.getName()}).begin(),
+                                std::vector<Name>({record3.getName(), record1.getName(), record2.getName()}).end());
+
+  // deleting prunes the nodes and releases the components only used by the record
+  storage.deleteData(record2.getName());
+  BOOST_CHECK_EQUAL(storage.getNNodes(), 7);
+  BOOST_CHECK_EQUAL(storage.getNComponents(), 5);
+  storage.deleteData(record1.getName());
+  BOOST_CHECK_EQUAL(storage.getNNodes(), 5);
+  BOOST_CHECK_EQUAL(storage.getNComponents(), 4);
+  storage.deleteData(record3.getName());
+  BOOST_CHECK_EQUAL(storage.getNNodes(), 1);
+  BOOST_CHECK_EQUAL(storage.getNComponents(), 0);
+
+  // freed nodes are reused
+  storage.addData(record1);
+  BOOST_CHECK_EQUAL(storage.m_nodes.size(), 8);
+  BOOST_CHECK_EQUAL(*storage.findData(record1.getName()), record1);
+}
+
+BOOST_AUTO_TEST_CASE(LatestData)
+{
+  CtTrie storage;
+  std::vector<Data> versions;
+  for (uint64_t version : {1, 2, 10}) {
+    versions.push_back(makeData(Name("/ndn/site1/abc").appendVersion(version)));
+    storage.addData(versions.back());
+  }
+  auto sibling = makeData(Name("/ndn/site1/abd").appendVersion(100));
+  storage.addData(sibling);
+
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[2]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(versions[0].getName()), versions[0]);
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name()), sibling);
+  BOOST_CHECK(storage.findLatestData(Name("/ndn/site1/ab")) == nullptr);
+
+  storage.deleteData(versions[2].getName());
+  BOOST_CHECK_EQUAL(*storage.findLatestData(Name("/ndn/site1/abc")), versions[1]);
+}
+
+BOOST_AUTO_TEST_CASE(ListNames)
+{
+  CtTrie storage;
+  std::vector<Name> names;
+  for (const auto& name : {"/ndn/site1/abc", "/ndn/site1/abc/v1", "/ndn/site1/abc/v2", "/ndn/site1/abd"}) {
+    storage.addData(makeData(name));
+    names.push_back(name);
+  }
+  storage.addData(makeData("/ndn/site2/abc"));
+
+  BOOST_CHECK(storage.listNames("/ndn/site1", nullopt, 2) == (std::vector<Name>{names[0], names[1]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", names[0], 2) == (std::vector<Name>{names[1], names[2]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", names[1], 5) == (std::vector<Name>{names[2], names[3]}));
+  // positions that are not stored
+  BOOST_CHECK(storage.listNames("/ndn/site1", Name("/ndn/site1/abc/v15"), 5) ==
+              (std::vector<Name>{names[2], names[3]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", Name("/ndn/site1/abcd"), 5) == (std::vector<Name>{names[3]}));
+  BOOST_CHECK(storage.listNames("/ndn/site1", Name("/ndn/site2"), 5).empty());
+  BOOST_CHECK(storage.listNames("/ndn/site1", Name("/ndn"), 1) == (std::vector<Name>{names[0]}));
+  BOOST_CHECK(storage.listNames("/ndn/site3", nullopt, 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(PrecedingName)
+{
+  CtTrie storage;
+  for (const auto& name : {"/ndn/site1/abc", "/ndn/site1/abc/v1", "/ndn/site1/abe", "/ndn/site2/abc"}) {
+    storage.addData(makeData(name));
+  }
+
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abd"), "/ndn/site1/abc/v1");
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abc/v0"), "/ndn/site1/abc");
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abc/v1/x"), "/ndn/site1/abc/v1");
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site1/abe"), "/ndn/site1/abc/v1");
+  BOOST_CHECK_EQUAL(*storage.findPrecedingName("/ndn/site1", "/ndn/site2"), "/ndn/site1/abe");
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site1", "/ndn/site1/abc"));
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site1", "/ndn/site0"));
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site2", "/ndn/site2/abb"));
+  BOOST_CHECK(!storage.findPrecedingName("/ndn/site3", "/ndn/site3/abc"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCtTrie
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,64 @@
+#include "storage/expiry-wheel.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+BOOST_AUTO_TEST_SUITE(TestExpiryWheel)
+
+BOOST_AUTO_TEST_CASE(Advance)
+{
+  auto now = time::fromUnixTimestamp(time::milliseconds(1000000));
+  ExpiryWheel wheel(1_s, 4, now);
+  wheel.insert("/a", now + 1_s);
+  wheel.insert("/b", now + 2500_ms);
+  // a revolution later than /a, in the same slot
+  wheel.insert("/c", now + 5_s);
+  // already expired
+  wheel.insert("/d", now - 10_s);
+  BOOST_CHECK_EQUAL(wheel.size(), 4);
+
+  std::vector<Name> expired;
+  auto onExpired = [&expired] (const Name& name) { expired.push_back(name); };
+  BOOST_CHECK(wheel.advance(now, 10, onExpired));
+  BOOST_CHECK(expired.empty());
+
+  BOOST_CHECK(wheel.advance(now + 1_s, 10, onExpired));
+  BOOST_CHECK(expired == (std::vector<Name>{"/d"}));
+
+  BOOST_CHECK(wheel.advance(now + 2_s, 10, onExpired));
+  BOOST_CHECK(expired == (std::vector<Name>{"/d", "/a"}));
+
+  BOOST_CHECK(wheel.advance(now + 3_s, 10, onExpired));
+  BOOST_CHECK(expired == (std::vector<Name>{"/d", "/a", "/b"}));
+
+  BOOST_CHECK(wheel.advance(now + 10_s, 10, onExpired));
+  BOOST_CHECK(expired == (std::vector<Name>{"/d", "/a", "/b", "/c"}));
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Budget)
+{
+  auto now = time::fromUnixTimestamp(time::milliseconds(1000000));
+  ExpiryWheel wheel(1_s, 16, now);
+  for (int i = 0; i < 10; i++) {
+    wheel.insert(Name("/a").appendNumber(i), now + 1_s);
+  }
+
+  size_t nExpired = 0;
+  auto onExpired = [&nExpired] (const Name&) { nExpired++; };
+  BOOST_CHECK(!wheel.advance(now + 2_s, 4, onExpired));
+  BOOST_CHECK_EQUAL(nExpired, 4);
+  BOOST_CHECK(!wheel.advance(now + 2_s, 4, onExpired));
+  BOOST_CHECK_EQUAL(nExpired, 8);
+  BOOST_CHECK(wheel.advance(now + 2_s, 4, onExpired));
+  BOOST_CHECK_EQUAL(nExpired, 10);
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestExpiryWheel
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,53 @@
+#include "nack-batch.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace nack;
+
+BOOST_AUTO_TEST_SUITE(TestNackBatch)
+
+BOOST_AUTO_TEST_CASE(MerkleTree)
+{
+  for (size_t nLeaves = 1; nLeaves <= 9; nLeaves++) {
+    BOOST_TEST_CONTEXT(nLeaves << " leaves") {
+      std::vector<Buffer> leaves;
+      for (size_t i = 0; i < nLeaves; i++) {
+        leaves.push_back(computeLeafDigest(Name("/ndn/site1").appendNumber(i)));
+      }
+      std::vector<std::vector<Buffer>> paths;
+      auto root = buildMerkleTree(leaves, paths);
+      BOOST_REQUIRE_EQUAL(paths.size(), nLeaves);
+      for (size_t i = 0; i < nLeaves; i++) {
+        BOOST_CHECK(computeMerkleRoot(leaves[i], i, paths[i]) == root);
+      }
+      // a leaf does not prove another position
+      if (nLeaves > 1) {
+        BOOST_CHECK(computeMerkleRoot(leaves[0], 1, paths[0]) != root);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  BatchProof proof;
+  proof.rootName = Name("/ndn/LEDGER/NACK-BATCH").appendVersion(1);
+  proof.leafIndex = 5;
+  proof.path = {computeLeafDigest("/a"), computeLeafDigest("/b")};
+
+  Data nack("/ndn/site1/abc/nack");
+  BOOST_CHECK(!decodeBatchProof(nack));
+  nack.setContent(encodeBatchProof(proof));
+  auto decoded = decodeBatchProof(nack);
+  BOOST_REQUIRE(decoded);
+  BOOST_CHECK_EQUAL(decoded->rootName, proof.rootName);
+  BOOST_CHECK_EQUAL(decoded->leafIndex, 5);
+  BOOST_CHECK(decoded->path == proof.path);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestNackBatch
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,121 @@
+#include "nack-cache.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+BOOST_FIXTURE_TEST_SUITE(TestNackCache, IdentityManagementTimeFixture)
+
+BOOST_AUTO_TEST_CASE(ReuseAndRefresh)
+{
+  NackCache cache(10, 10_s);
+  auto nack = std::make_shared<const Data>(Name("/ndn/site1/abc/nack"));
+  cache.insert("/ndn/site1/abc", false, nack);
+  BOOST_CHECK(cache.find("/ndn/site1/abc", true) == nullptr);
+
+  auto entry = cache.find("/ndn/site1/abc", false);
+  BOOST_REQUIRE(entry != nullptr);
+  BOOST_CHECK_EQUAL(entry->nack, nack);
+  BOOST_CHECK(!cache.needsRefresh(*entry));
+
+  advanceClocks(1_s, 6);
+  entry = cache.find("/ndn/site1/abc", false);
+  BOOST_REQUIRE(entry != nullptr);
+  BOOST_CHECK(cache.needsRefresh(*entry));
+  cache.markRefreshing("/ndn/site1/abc", false);
+  BOOST_CHECK(!cache.needsRefresh(*entry));
+
+  auto newNack = std::make_shared<const Data>(Name("/ndn/site1/abc/nack/2"));
+  cache.refresh("/ndn/site1/abc", false, newNack);
+  advanceClocks(1_s, 6);
+  entry = cache.find("/ndn/site1/abc", false);
+  BOOST_REQUIRE(entry != nullptr);
+  BOOST_CHECK_EQUAL(entry->nack, newNack);
+
+  // too close to the end of the freshness period
+  advanceClocks(1_s, 3);
+  BOOST_CHECK(cache.find("/ndn/site1/abc", false) == nullptr);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ReplyFreshness)
+{
+  NackCache cache(10, 10_s);
+  auto nack = std::make_shared<Data>(Name("/ndn/site1/abc/nack"));
+  nack->setFreshnessPeriod(10_s);
+  cache.insert("/ndn/site1/abc", false, nack);
+  int nSigned = 0;
+  auto sign = [&] (Data&) { nSigned++; };
+
+  BOOST_CHECK(cache.makeReply("/ndn/site1/abd", false, sign) == nullptr);
+  advanceClocks(1_s, 3);
+  // the freshness period ends one step, 1s, before the lifetime
+  auto reply = cache.makeReply("/ndn/site1/abc", false, sign);
+  BOOST_REQUIRE(reply != nullptr);
+  BOOST_CHECK_EQUAL(reply->getName(), nack->getName());
+  BOOST_CHECK_EQUAL(reply->getFreshnessPeriod(), 6_s);
+  BOOST_CHECK_EQUAL(nack->getFreshnessPeriod(), 10_s);
+
+  // the same reply serves the step
+  advanceClocks(100_ms, 5);
+  BOOST_CHECK_EQUAL(cache.makeReply("/ndn/site1/abc", false, sign), reply);
+  BOOST_CHECK_EQUAL(nSigned, 1);
+
+  advanceClocks(100_ms, 5);
+  reply = cache.makeReply("/ndn/site1/abc", false, sign);
+  BOOST_CHECK_EQUAL(reply->getFreshnessPeriod(), 5_s);
+  BOOST_CHECK_EQUAL(nSigned, 2);
+}
+
+BOOST_AUTO_TEST_CASE(Invalidate)
+{
+  NackCache cache(10, 10_s);
+  auto nack = std::make_shared<const Data>(Name("/nack"));
+  cache.insert("/ndn/site1", true, nack);
+  cache.insert("/ndn/site1", false, nack);
+  cache.insert("/ndn/site1/abc", false, nack);
+  cache.insert("/ndn/site1/abd", true, nack);
+
+  cache.invalidate("/ndn/site1/abc");
+  BOOST_CHECK(cache.find("/ndn/site1", true) == nullptr);
+  BOOST_CHECK(cache.find("/ndn/site1/abc", false) == nullptr);
+  // an exact query for a prefix and other names keep their nacks
+  BOOST_CHECK(cache.find("/ndn/site1", false) != nullptr);
+  BOOST_CHECK(cache.find("/ndn/site1/abd", true) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Capacity)
+{
+  NackCache cache(2, 10_s);
+  auto nack = std::make_shared<const Data>(Name("/nack"));
+  cache.insert("/a", false, nack);
+  cache.insert("/b", false, nack);
+  BOOST_CHECK(cache.find("/a", false) != nullptr);
+  cache.insert("/c", false, nack);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  // the least recently used one is evicted
+  BOOST_CHECK(cache.find("/b", false) == nullptr);
+  BOOST_CHECK(cache.find("/a", false) != nullptr);
+  BOOST_CHECK(cache.find("/c", false) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(BatchRoot)
+{
+  NackCache cache(1, 10_s);
+  auto nack = std::make_shared<const Data>(Name("/nack"));
+  auto root = std::make_shared<const Data>(Name("/ndn/LEDGER/NACK-BATCH").appendVersion(1));
+  cache.insert("/a", false, nack, root);
+  BOOST_CHECK_EQUAL(cache.find("/a", false)->root, root);
+  BOOST_CHECK_EQUAL(root.use_count(), 2);
+
+  // the root is released with the last nack of its batch
+  cache.insert("/b", false, nack);
+  BOOST_CHECK_EQUAL(root.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestNackCache
+
+} // namespace tests
+} // namespace ndnrevoke
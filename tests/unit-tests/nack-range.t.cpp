@@ -0,0 +1,53 @@
+#include "nack-range.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace nack;
+
+BOOST_FIXTURE_TEST_SUITE(TestNackRange, IdentityManagementFixture)
+
+BOOST_AUTO_TEST_CASE(Covers)
+{
+  RangeStatement range{"/ndn/site1", Name("/ndn/site1/abc"), Name("/ndn/site1/abe")};
+  BOOST_CHECK(range.covers("/ndn/site1/abd", false));
+  BOOST_CHECK(range.covers("/ndn/site1/abd", true));
+  BOOST_CHECK(range.covers("/ndn/site1/abc/1", true));
+  // the bounds are stored
+  BOOST_CHECK(!range.covers("/ndn/site1/abc", false));
+  BOOST_CHECK(!range.covers("/ndn/site1/abe", false));
+  // /ndn/site1/abe starts with /ndn/site1/ab
+  BOOST_CHECK(range.covers("/ndn/site1/abc0", false));
+  BOOST_CHECK(!range.covers("/ndn/site1/ab", true));
+  BOOST_CHECK(!range.covers("/ndn/site2/abd", false));
+
+  RangeStatement zone{"/ndn/site1", nullopt, nullopt};
+  BOOST_CHECK(zone.covers("/ndn/site1", true));
+  BOOST_CHECK(zone.covers("/ndn/site1/abc", true));
+  BOOST_CHECK(!zone.covers("/ndn/site2", true));
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  Data statement("/ndn/LEDGER/RANGE/v=1");
+  statement.setContent(encodeRangeStatement({"/ndn/site1", nullopt, Name("/ndn/site1/abe")}));
+  m_keyChain.sign(statement, ndn::signingWithSha256());
+  auto range = decodeRangeStatement(statement);
+  BOOST_CHECK_EQUAL(range.zone, "/ndn/site1");
+  BOOST_CHECK(!range.lower);
+  BOOST_CHECK_EQUAL(*range.upper, "/ndn/site1/abe");
+
+  Data nack("/ndn/site1/abd/nack");
+  BOOST_CHECK(!decodeRangeNack(nack));
+  nack.setContent(encodeRangeNack(statement));
+  auto embedded = decodeRangeNack(nack);
+  BOOST_REQUIRE(embedded);
+  BOOST_CHECK_EQUAL(embedded->getName(), statement.getName());
+  BOOST_CHECK(decodeRangeStatement(*embedded).upper == range.upper);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestNackRange
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,62 @@
+#include "name-lru-map.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestNameLruMap)
+
+BOOST_AUTO_TEST_CASE(EvictLeastRecentlyUsed)
+{
+  NameLruMap<int> map(2);
+  map.insert("/a", 1);
+  map.insert("/b", 2);
+  // /a becomes the most recently used entry
+  BOOST_REQUIRE(map.find("/a") != nullptr);
+  map.insert("/c", 3);
+  BOOST_CHECK_EQUAL(map.size(), 2);
+  BOOST_CHECK(map.find("/b") == nullptr);
+  BOOST_CHECK_EQUAL(*map.find("/a"), 1);
+  BOOST_CHECK_EQUAL(*map.find("/c"), 3);
+
+  // replacing a value does not evict
+  map.insert("/c", 4);
+  BOOST_CHECK_EQUAL(map.size(), 2);
+  BOOST_CHECK_EQUAL(*map.find("/c"), 4);
+
+  map.erase("/a");
+  BOOST_CHECK_EQUAL(map.size(), 1);
+  BOOST_CHECK(map.find("/a") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(FindFloor)
+{
+  NameLruMap<int> map(2);
+  map.insert("/a", 1);
+  map.insert("/c", 3);
+
+  BOOST_CHECK(map.findFloor("/0").first == nullptr);
+  auto floor = map.findFloor("/b");
+  BOOST_REQUIRE(floor.first != nullptr);
+  BOOST_CHECK_EQUAL(*floor.first, "/a");
+  BOOST_CHECK_EQUAL(*floor.second, 1);
+
+  // the floor lookup counts as a use of /a
+  map.insert("/d", 4);
+  BOOST_CHECK(map.find("/c") == nullptr);
+  BOOST_CHECK(map.find("/a") != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Unbounded)
+{
+  NameLruMap<int> map(0);
+  for (int i = 0; i < 100; i++) {
+    map.insert(Name("/a").appendNumber(i), i);
+  }
+  BOOST_CHECK_EQUAL(map.size(), 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestNameLruMap
+
+} // namespace tests
+} // namespace ndnrevoke
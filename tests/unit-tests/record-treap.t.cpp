@@ -0,0 +1,84 @@
+#include "storage/record-treap.hpp"
+#include "test-common.hpp"
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+BOOST_AUTO_TEST_SUITE(TestRecordTreap)
+
+static std::shared_ptr<const Data>
+makeData(const Name& name)
+{
+  return std::make_shared<const Data>(name);
+}
+
+static std::vector<Name>
+collect(const RecordTreap& treap, const Name& from = Name(), bool isInclusive = true)
+{
+  std::vector<Name> names;
+  treap.visit(from, isInclusive, [&names] (const auto& data) {
+    names.push_back(data->getName());
+    return true;
+  });
+  return names;
+}
+
+BOOST_AUTO_TEST_CASE(Ordering)
+{
+  RecordTreap treap;
+  std::set<Name> expected;
+  // insert in a scrambled order, visits are sorted
+  for (uint64_t i = 0; i < 1000; i++) {
+    Name name = Name("/ndn").appendNumber((i * 7919) % 1000);
+    treap.insert(makeData(name));
+    expected.insert(name);
+  }
+  BOOST_CHECK_EQUAL(treap.size(), 1000);
+  BOOST_CHECK(collect(treap) == std::vector<Name>(expected.begin(), expected.end()));
+
+  for (uint64_t i = 0; i < 1000; i += 2) {
+    BOOST_CHECK(treap.erase(Name("/ndn").appendNumber(i)));
+    expected.erase(Name("/ndn").appendNumber(i));
+  }
+  BOOST_CHECK(!treap.erase(Name("/ndn").appendNumber(0)));
+  BOOST_CHECK_EQUAL(treap.size(), 500);
+  BOOST_CHECK(collect(treap) == std::vector<Name>(expected.begin(), expected.end()));
+
+  BOOST_CHECK(treap.find(Name("/ndn").appendNumber(1)) != nullptr);
+  BOOST_CHECK(treap.find(Name("/ndn").appendNumber(2)) == nullptr);
+  BOOST_CHECK_EQUAL(treap.findLast("/ndn")->getName(), Name("/ndn").appendNumber(999));
+  BOOST_CHECK(treap.findLast("/other") == nullptr);
+
+  auto names = collect(treap, Name("/ndn").appendNumber(1), false);
+  BOOST_REQUIRE(!names.empty());
+  BOOST_CHECK_EQUAL(names.front(), Name("/ndn").appendNumber(3));
+}
+
+BOOST_AUTO_TEST_CASE(Snapshot)
+{
+  RecordTreap treap;
+  for (uint64_t i = 0; i < 100; i++) {
+    treap.insert(makeData(Name("/ndn").appendNumber(i)));
+  }
+  RecordTreap snapshot = treap;
+  auto before = collect(snapshot);
+
+  for (uint64_t i = 0; i < 100; i += 3) {
+    treap.erase(Name("/ndn").appendNumber(i));
+  }
+  treap.insert(makeData("/ndn/new"));
+  BOOST_CHECK_EQUAL(treap.size(), 67);
+
+  // the snapshot is unaffected by the updates
+  BOOST_CHECK_EQUAL(snapshot.size(), 100);
+  BOOST_CHECK(collect(snapshot) == before);
+  BOOST_CHECK(snapshot.find("/ndn/new") == nullptr);
+  BOOST_CHECK(snapshot.find(Name("/ndn").appendNumber(0)) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestRecordTreap
+
+} // namespace tests
+} // namespace ndnrevoke
@@ -0,0 +1,57 @@
+#include "signing-key-cache.hpp"
+#include "test-common.hpp"
+
+#include <ndn-cxx/security/verification-helpers.hpp>
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+
+BOOST_FIXTURE_TEST_SUITE(TestSigningKeyCache, IdentityManagementFixture)
+
+BOOST_AUTO_TEST_CASE(ResolveIdentity)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  auto cert = identity.getDefaultKey().getDefaultCertificate();
+  SigningKeyCache cache(m_keyChain);
+
+  auto signer = cache.resolve(ndn::signingByIdentity("/ndn"));
+  // the key is copied into the KeyChain of the cache
+  BOOST_CHECK(&signer.getKeyChain() != &m_keyChain);
+  Data cached("/ndn/data");
+  signer.sign(cached);
+  BOOST_CHECK(ndn::security::verifySignature(cached, cert));
+
+  // same KeyLocator as signing through the KeyChain
+  Data direct("/ndn/data");
+  m_keyChain.sign(direct, ndn::signingByIdentity("/ndn"));
+  BOOST_CHECK_EQUAL(cached.getKeyLocator()->getName(), direct.getKeyLocator()->getName());
+
+  // the key is imported once
+  auto again = cache.resolve(ndn::signingByKey(cert.getKeyName()));
+  Data other("/ndn/other");
+  again.sign(other);
+  BOOST_CHECK(ndn::security::verifySignature(other, cert));
+
+  auto byCert = cache.resolve(ndn::signingByCertificate(cert.getName()));
+  Data certSigned("/ndn/cert-signed");
+  byCert.sign(certSigned);
+  BOOST_CHECK_EQUAL(certSigned.getKeyLocator()->getName(), cert.getName());
+}
+
+BOOST_AUTO_TEST_CASE(ResolveWithoutKey)
+{
+  SigningKeyCache cache(m_keyChain);
+  auto signer = cache.resolve(ndn::signingWithSha256());
+  Data data("/ndn/data");
+  signer.sign(data);
+  BOOST_CHECK_EQUAL(data.getSignatureType(), ndn::tlv::DigestSha256);
+
+  BOOST_CHECK_THROW(cache.resolve(ndn::signingByIdentity("/nonexistent")), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSigningKeyCache
+
+} // namespace tests
+} // namespace ndnrevoke
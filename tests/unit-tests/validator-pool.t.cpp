@@ -0,0 +1,75 @@
+#include "validator-pool.hpp"
+#include "test-common.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/asio/steady_timer.hpp>
+
+namespace ndnrevoke {
+namespace tests {
+
+using namespace ct;
+using ndn::util::DummyClientFace;
+
+BOOST_FIXTURE_TEST_SUITE(TestValidatorPool, IdentityManagementTimeFixture)
+
+BOOST_AUTO_TEST_CASE(Validate)
+{
+  auto identity = addIdentity(Name("/ndn"));
+  saveCertificate(identity, "tests/unit-tests/config-files/trust-anchor.ndncert");
+  std::vector<Certificate> certs;
+  for (int i = 0; i < 40; i++) {
+    auto device = addSubCertificate(Name("/ndn/site1").appendNumber(i), identity);
+    certs.push_back(device.getDefaultKey().getDefaultCertificate());
+  }
+  // the trust schema asks for ECDSA
+  Certificate invalid = certs.back();
+  m_keyChain.sign(invalid, ndn::signingWithSha256());
+
+  ValidatorPool pool(io, "tests/unit-tests/config-files/trust-schema.conf", 4,
+                     [this] (boost::asio::io_service& workerIo) {
+                       return std::make_unique<DummyClientFace>(workerIo, m_keyChain);
+                     });
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+
+  std::set<Name> valid;
+  size_t nInvalid = 0;
+  size_t nResults = 0;
+  // the results are delivered on the io_service of the test, which runs until the last one
+  auto onResult = [&] {
+    if (++nResults == certs.size() + 1) {
+      io.stop();
+    }
+  };
+  for (const auto& cert : certs) {
+    pool.validate(cert,
+                  [&valid, onResult] (const Data& data) { valid.insert(data.getName()); onResult(); },
+                  [onResult] (auto&&...) { BOOST_ERROR("Unexpected failure"); onResult(); });
+  }
+  pool.validate(invalid,
+                [onResult] (auto&&) { BOOST_ERROR("Unexpected success"); onResult(); },
+                [&nInvalid, onResult] (auto&&...) { nInvalid++; onResult(); });
+
+  // the validations need no timer, a wall clock deadline only bounds a broken pool
+  boost::asio::steady_timer deadline(io, std::chrono::seconds(10));
+  deadline.async_wait([this] (const boost::system::error_code& error) {
+    if (!error) {
+      BOOST_ERROR("Validations did not complete");
+      io.stop();
+    }
+  });
+  boost::asio::io_service::work work(io);
+  io.run();
+  deadline.cancel();
+  io.restart();
+  io.poll();
+
+  BOOST_CHECK_EQUAL(nResults, certs.size() + 1);
+  BOOST_CHECK_EQUAL(valid.size(), certs.size());
+  BOOST_CHECK_EQUAL(nInvalid, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestValidatorPool
+
+} // namespace tests
+} // namespace ndnrevoke
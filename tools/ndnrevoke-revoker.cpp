@@ -81,7 +81,7 @@ submitRecord(const Name& revokerPrefix, const Name& ledgerName, const std::share
 
 	std::string errorMsg = "ERROR: Ledger cannot log the submitted record because of ";
 	client->appendData(Name(ledgerName).append("append"), {*data},
-		[errorMsg] (auto&&, auto& ack) {
+		[errorMsg] (auto&&, auto& ack, auto&&) {
 			using aa = appendtlv::AppendStatus;
 			Block content = ack.getContent();
 			content.parse();
@@ -100,6 +100,10 @@ submitRecord(const Name& revokerPrefix, const Name& ledgerName, const std::share
 											<< "Internal storage error "
 											<< "(ledger may have logged the same record)\n";
 						break;
+					case aa::FAILURE_QUOTA:
+						std::cerr << errorMsg
+											<< "Record zone is over its storage quota\n";
+						break;
 					case aa::FAILURE_TIMEOUT:
 						std::cerr << errorMsg 
 											<< "Ledger Interest timeout\n";